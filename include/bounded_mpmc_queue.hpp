@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-capacity lock-free queue for handing small POD records between tasks
+// (Dmitry Vyukov's bounded MPMC algorithm). Each cell carries a sequence number
+// that tells producers and consumers whether it is free or filled, so tryPush()
+// and tryPop() are a single CAS in the common case and never block, allocate,
+// or take a FreeRTOS mutex. Both return false instead of waiting when the queue
+// is full or empty.
+template <typename T, size_t Capacity>
+class BoundedMpmcQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "BoundedMpmcQueue capacity must be a power of two");
+
+public:
+  BoundedMpmcQueue() : enqueuePos(0), dequeuePos(0) {
+    for (size_t i = 0; i < Capacity; i++) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+  BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+
+  // Enqueue a copy of value; returns false if the queue is full
+  bool tryPush(const T& value) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell = &cells[pos & (Capacity - 1)];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+      if (diff == 0) {
+        if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // Full
+      } else {
+        pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = value;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Dequeue the oldest entry into value; returns false if the queue is empty
+  bool tryPop(T& value) {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell = &cells[pos & (Capacity - 1)];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+      if (diff == 0) {
+        if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // Empty
+      } else {
+        pos = dequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+    value = cell->value;
+    cell->sequence.store(pos + Capacity, std::memory_order_release);
+    return true;
+  }
+
+  // Number of queued entries; only a snapshot while other tasks are active
+  size_t sizeApprox() const {
+    size_t head = dequeuePos.load(std::memory_order_relaxed);
+    size_t tail = enqueuePos.load(std::memory_order_relaxed);
+    return tail >= head ? tail - head : 0;
+  }
+
+  size_t capacity() const { return Capacity; }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  Cell cells[Capacity];
+  std::atomic<size_t> enqueuePos;
+  std::atomic<size_t> dequeuePos;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstring>
+
+// What a check type needs from the rest of the firmware
+enum CheckTypeFlags {
+  CHECK_NEEDS_HOST = 1 << 0,   // A target host is required (import/validation)
+  CHECK_USES_PORT = 1 << 1,    // The port is part of the target (shown in notifications)
+  CHECK_HAS_LATENCY = 1 << 2,  // Network probe; its duration is recorded as latency
+  CHECK_PASSIVE = 1 << 3       // Judged from received heartbeats, never probed
+};
+
+// Compile-time list of check types. Each entry is a descriptor with static members:
+//   static int id();              stable numeric id (persisted in services.json)
+//   static const char* name();    API and JSON name, e.g. "http_get"
+//   static unsigned flags();      CheckTypeFlags
+//   static const char* fields();  comma-separated type-specific JSON fields
+//   static bool probe(const Plan&, Outcome&);
+// Lookups and dispatch recurse over the list at compile time, so a probe is a
+// chain of integer compares ending in a direct call, and a type left out of the
+// list is never referenced: its probe and the libraries behind it aren't linked.
+// Unknown ids report no name, no flags, and a probe that fails.
+template <typename... Types>
+struct CheckTypeRegistry;
+
+template <>
+struct CheckTypeRegistry<> {
+  static const int COUNT = 0;
+
+  static bool contains(int) { return false; }
+  static const char* name(int) { return nullptr; }
+  static int parse(const char*) { return -1; }
+  static unsigned flags(int) { return 0; }
+  static const char* fields(int) { return ""; }
+
+  template <typename Plan, typename Outcome>
+  static bool probe(int, const Plan&, Outcome&) { return false; }
+
+  // Call visit(id, name, flags, fields) for each type in list order
+  template <typename Visitor>
+  static void forEach(Visitor&) {}
+};
+
+template <typename First, typename... Rest>
+struct CheckTypeRegistry<First, Rest...> {
+  typedef CheckTypeRegistry<Rest...> Next;
+  static const int COUNT = 1 + Next::COUNT;
+
+  static bool contains(int id) { return id == First::id() || Next::contains(id); }
+
+  static const char* name(int id) { return id == First::id() ? First::name() : Next::name(id); }
+
+  // Id for an API name, or -1 if no built-in type has it
+  static int parse(const char* name) {
+    return strcmp(name, First::name()) == 0 ? First::id() : Next::parse(name);
+  }
+
+  static unsigned flags(int id) { return id == First::id() ? First::flags() : Next::flags(id); }
+
+  static const char* fields(int id) { return id == First::id() ? First::fields() : Next::fields(id); }
+
+  template <typename Plan, typename Outcome>
+  static bool probe(int id, const Plan& plan, Outcome& outcome) {
+    return id == First::id() ? First::probe(plan, outcome) : Next::probe(id, plan, outcome);
+  }
+
+  template <typename Visitor>
+  static void forEach(Visitor& visit) {
+    visit(First::id(), First::name(), First::flags(), First::fields());
+    Next::forEach(visit);
+  }
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// FieldCount NUL-terminated strings packed into one immutable heap block that
+// copies share through an atomic refcount. set() builds a fresh block with the
+// new value (copy-on-write), so a copy taken by another task never sees a
+// half-edited value, and copying the owner costs a refcount bump instead of one
+// allocation per string. Unset fields read as "". A set() that returns false
+// (heap exhausted, or more than 64 KB in total) leaves every field unchanged.
+template <size_t FieldCount>
+class ConfigStringArena {
+public:
+  ConfigStringArena() : block(nullptr) {}
+  ConfigStringArena(const ConfigStringArena& other) : block(other.block) { retain(); }
+  ~ConfigStringArena() { release(); }
+
+  ConfigStringArena& operator=(const ConfigStringArena& other) {
+    if (block != other.block) {
+      Block* previous = block;
+      block = other.block;
+      retain();
+      releaseBlock(previous);
+    }
+    return *this;
+  }
+
+  const char* get(size_t field) const {
+    return block ? block->data + block->offsets[field] : "";
+  }
+
+  size_t length(size_t field) const {
+    return block ? block->offsets[field + 1] - block->offsets[field] - 1 : 0;
+  }
+
+  bool set(size_t field, const char* value) {
+    return set(field, value, value ? strlen(value) : 0);
+  }
+
+  // Works with Arduino String and anything else exposing c_str()/length()
+  template <typename StringLike>
+  bool set(size_t field, const StringLike& value) {
+    return set(field, value.c_str(), value.length());
+  }
+
+  bool set(size_t field, const char* value, size_t len) {
+    size_t total = 0;
+    for (size_t i = 0; i < FieldCount; i++) {
+      total += (i == field ? len : length(i)) + 1;
+    }
+    if (total > UINT16_MAX) {
+      return false;  // Offsets are 16-bit; config strings are far shorter in practice
+    }
+
+    void* memory = malloc(offsetof(Block, data) + total);
+    if (memory == nullptr) {
+      return false;
+    }
+    Block* next = new (memory) Block();
+    size_t offset = 0;
+    for (size_t i = 0; i < FieldCount; i++) {
+      const char* source = i == field ? value : get(i);
+      size_t sourceLen = i == field ? len : length(i);
+      next->offsets[i] = (uint16_t)offset;
+      if (sourceLen > 0) {
+        memcpy(next->data + offset, source, sourceLen);
+      }
+      next->data[offset + sourceLen] = '\0';
+      offset += sourceLen + 1;
+    }
+    next->offsets[FieldCount] = (uint16_t)offset;
+
+    releaseBlock(block);
+    block = next;
+    return true;
+  }
+
+  // Heap bytes held by the shared block (0 when every field is empty)
+  size_t bytes() const {
+    return block ? offsetof(Block, data) + block->offsets[FieldCount] : 0;
+  }
+
+private:
+  struct Block {
+    Block() : refs(1) {}
+    std::atomic<int> refs;
+    uint16_t offsets[FieldCount + 1];  // offsets[FieldCount] = total bytes used
+    char data[1];
+  };
+
+  void retain() {
+    if (block) block->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void release() {
+    releaseBlock(block);
+    block = nullptr;
+  }
+
+  static void releaseBlock(Block* target) {
+    if (target && target->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      target->~Block();
+      free(target);
+    }
+  }
+
+  Block* block;
+};
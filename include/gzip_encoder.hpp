@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Minimal one-shot gzip encoder for small in-memory documents (pre-rendered pages).
+// Emits a single fixed-Huffman deflate block with greedy LZ77 over a 4 KB window,
+// which is enough for repetitive HTML/SVG markup. Scratch state is ~20 KB and
+// only lives for the duration of the call, drawn from out's allocator; nothing is
+// kept between calls.
+class GzipEncoder {
+public:
+  // Compress len bytes of in into out, replacing its contents
+  template <typename Alloc>
+  static void compress(const uint8_t* in, size_t len, std::vector<uint8_t, Alloc>& out) {
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<int32_t> ScratchAlloc;
+    std::vector<int32_t, ScratchAlloc> head(HASH_SIZE, -1, ScratchAlloc(out.get_allocator()));
+    std::vector<int32_t, ScratchAlloc> prev(WINDOW_SIZE, -1, ScratchAlloc(out.get_allocator()));
+
+    out.clear();
+    out.reserve(len / 3 + 64);
+    static const uint8_t header[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+    out.insert(out.end(), header, header + sizeof(header));
+
+    BitWriter<std::vector<uint8_t, Alloc> > bits(out);
+    bits.write(1, 1);  // BFINAL
+    bits.write(1, 2);  // BTYPE = fixed Huffman
+
+    size_t pos = 0;
+    while (pos < len) {
+      size_t bestLength = 0;
+      size_t bestDistance = 0;
+      if (pos + MIN_MATCH <= len) {
+        uint32_t hash = hash3(in + pos);
+        int32_t candidate = head[hash];
+        int chain = MAX_CHAIN;
+        size_t maxLength = len - pos < MAX_MATCH ? len - pos : MAX_MATCH;
+        while (candidate >= 0 && chain-- > 0 && pos - candidate <= WINDOW_SIZE) {
+          size_t length = 0;
+          while (length < maxLength && in[candidate + length] == in[pos + length]) {
+            length++;
+          }
+          if (length > bestLength) {
+            bestLength = length;
+            bestDistance = pos - candidate;
+            if (length == maxLength) break;
+          }
+          candidate = prev[candidate & (WINDOW_SIZE - 1)];
+        }
+      }
+
+      size_t advance = 1;
+      if (bestLength >= MIN_MATCH) {
+        writeLength(bits, bestLength);
+        writeDistance(bits, bestDistance);
+        advance = bestLength;
+      } else {
+        writeLiteral(bits, in[pos]);
+      }
+
+      // Index every position we step over so later matches can reference it
+      for (size_t i = 0; i < advance; i++, pos++) {
+        if (pos + MIN_MATCH <= len) {
+          uint32_t hash = hash3(in + pos);
+          prev[pos & (WINDOW_SIZE - 1)] = head[hash];
+          head[hash] = (int32_t)pos;
+        }
+      }
+    }
+
+    writeLiteral(bits, 256);  // End of block
+    bits.flush();
+
+    uint32_t crc = crc32(in, len);
+    for (int i = 0; i < 4; i++) out.push_back((uint8_t)(crc >> (8 * i)));
+    for (int i = 0; i < 4; i++) out.push_back((uint8_t)((uint32_t)len >> (8 * i)));
+  }
+
+private:
+  static const size_t WINDOW_SIZE = 4096;  // Power of two, at most 32768
+  static const size_t HASH_SIZE = 1024;    // Power of two
+  static const size_t MIN_MATCH = 3;
+  static const size_t MAX_MATCH = 258;
+  static const int MAX_CHAIN = 16;
+
+  // Deflate packs bits LSB-first; Huffman codes are stored MSB-first
+  template <typename Buffer>
+  class BitWriter {
+  public:
+    explicit BitWriter(Buffer& out) : out(out), buffer(0), count(0) {}
+
+    void write(uint32_t value, int length) {
+      buffer |= value << count;
+      count += length;
+      while (count >= 8) {
+        out.push_back((uint8_t)buffer);
+        buffer >>= 8;
+        count -= 8;
+      }
+    }
+
+    void writeCode(uint32_t code, int length) {
+      uint32_t reversed = 0;
+      for (int i = 0; i < length; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+      }
+      write(reversed, length);
+    }
+
+    void flush() {
+      if (count > 0) {
+        out.push_back((uint8_t)buffer);
+        buffer = 0;
+        count = 0;
+      }
+    }
+
+  private:
+    Buffer& out;
+    uint32_t buffer;
+    int count;
+  };
+
+  static uint32_t hash3(const uint8_t* p) {
+    return ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & (HASH_SIZE - 1);
+  }
+
+  // Fixed literal/length code (RFC 1951 section 3.2.6)
+  template <typename Bits>
+  static void writeLiteral(Bits& bits, uint32_t symbol) {
+    if (symbol < 144) {
+      bits.writeCode(0x30 + symbol, 8);
+    } else if (symbol < 256) {
+      bits.writeCode(0x190 + (symbol - 144), 9);
+    } else if (symbol < 280) {
+      bits.writeCode(symbol - 256, 7);
+    } else {
+      bits.writeCode(0xc0 + (symbol - 280), 8);
+    }
+  }
+
+  template <typename Bits>
+  static void writeLength(Bits& bits, size_t length) {
+    static const uint16_t base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+                                      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                      2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    int code = 28;
+    while (base[code] > length) code--;
+    writeLiteral(bits, 257 + code);
+    if (extra[code] > 0) bits.write(length - base[code], extra[code]);
+  }
+
+  template <typename Bits>
+  static void writeDistance(Bits& bits, size_t distance) {
+    static const uint16_t base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                      193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                      6145, 8193, 12289, 16385, 24577};
+    static const uint8_t extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                      6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    int code = 29;
+    while (base[code] > distance) code--;
+    bits.writeCode(code, 5);
+    if (extra[code] > 0) bits.write(distance - base[code], extra[code]);
+  }
+
+  // Bitwise CRC-32 (gzip trailer); pages are small and rebuilt rarely
+  static uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < len; i++) {
+      crc ^= data[i];
+      for (int k = 0; k < 8; k++) {
+        crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+      }
+    }
+    return ~crc;
+  }
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Open-addressing hash index (linear probing) from a string key's 32-bit hash to
+// a small integer slot in some caller-owned table. Only hashes and slot numbers
+// are stored; find() and erase() take a predicate that confirms a candidate slot
+// really holds the key, so the index never copies or owns strings and a hash
+// collision costs one extra compare. Not thread-safe: callers serialize access
+// the same way they serialize access to the table being indexed.
+class IdHashIndex {
+public:
+  IdHashIndex() : mask(0), used(0) {}
+
+  // Size the table for up to maxEntries keys at <= 50% load and clear it
+  void reset(size_t maxEntries) {
+    size_t capacity = 2;
+    while (capacity < maxEntries * 2) capacity <<= 1;
+    entries.assign(capacity, Entry());
+    mask = capacity - 1;
+    used = 0;
+  }
+
+  void clear() {
+    for (size_t i = 0; i < entries.size(); i++) entries[i] = Entry();
+    used = 0;
+  }
+
+  // Add a key's slot; the caller makes sure the key isn't already present.
+  // Returns false when the table is full (more keys than reset() was sized for).
+  bool insert(uint32_t hash, int slot) {
+    if (entries.empty() || used >= entries.size() - 1) {
+      return false;
+    }
+    size_t pos = hash & mask;
+    while (entries[pos].slot != EMPTY) {
+      pos = (pos + 1) & mask;
+    }
+    entries[pos].hash = hash;
+    entries[pos].slot = slot;
+    used++;
+    return true;
+  }
+
+  // Slot whose key has this hash and satisfies matches(slot), or -1
+  template <typename Matches>
+  int find(uint32_t hash, Matches matches) const {
+    if (entries.empty()) return -1;
+    size_t pos = hash & mask;
+    while (entries[pos].slot != EMPTY) {
+      if (entries[pos].hash == hash && matches(entries[pos].slot)) {
+        return entries[pos].slot;
+      }
+      pos = (pos + 1) & mask;
+    }
+    return -1;
+  }
+
+  // Remove the matching key. Later entries of the probe run are shifted back so
+  // lookups never need tombstones.
+  template <typename Matches>
+  bool erase(uint32_t hash, Matches matches) {
+    if (entries.empty()) return false;
+    size_t pos = hash & mask;
+    while (entries[pos].slot != EMPTY) {
+      if (entries[pos].hash == hash && matches(entries[pos].slot)) {
+        break;
+      }
+      pos = (pos + 1) & mask;
+    }
+    if (entries[pos].slot == EMPTY) {
+      return false;
+    }
+
+    size_t hole = pos;
+    size_t next = (hole + 1) & mask;
+    while (entries[next].slot != EMPTY) {
+      size_t home = entries[next].hash & mask;
+      // Move the entry into the hole unless its home lies cyclically in (hole, next]
+      bool homeAfterHole = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+      if (!homeAfterHole) {
+        entries[hole] = entries[next];
+        hole = next;
+      }
+      next = (next + 1) & mask;
+    }
+    entries[hole] = Entry();
+    used--;
+    return true;
+  }
+
+  size_t size() const { return used; }
+  size_t capacity() const { return entries.size(); }
+
+private:
+  static const int EMPTY = -1;
+
+  struct Entry {
+    Entry() : hash(0), slot(EMPTY) {}
+    uint32_t hash;
+    int32_t slot;
+  };
+
+  std::vector<Entry> entries;
+  size_t mask;
+  size_t used;
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include <esp_heap_caps.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// Heap pool for one subsystem's JSON documents and scratch buffers. Blocks go to
+// PSRAM when the board has it and to the internal heap otherwise (or when PSRAM
+// is exhausted), so the internal heap is left to WiFi, TLS and the display. An
+// 8-byte header records each block's size and region, which lets the pool report
+// how many bytes it holds in each region. Counters are atomic, so documents can
+// be built on any task. Implements ArduinoJson's Allocator interface; wrap it in
+// PsramStdAllocator for std::vector.
+class PsramAllocator : public ArduinoJson::Allocator {
+public:
+  explicit PsramAllocator(const char* name)
+    : poolName(name), internal(0), psram(0), peak(0), fallbacks(0) {}
+
+  PsramAllocator(const PsramAllocator&) = delete;
+  PsramAllocator& operator=(const PsramAllocator&) = delete;
+
+  void* allocate(size_t size) override {
+    Header* header = nullptr;
+    bool inPsram = false;
+    if (psramAvailable()) {
+      header = static_cast<Header*>(heap_caps_malloc(sizeof(Header) + size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+      inPsram = header != nullptr;
+      if (!inPsram) fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (header == nullptr) {
+      header = static_cast<Header*>(heap_caps_malloc(sizeof(Header) + size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    }
+    if (header == nullptr) {
+      return nullptr;
+    }
+    header->size = (uint32_t)size;
+    header->inPsram = inPsram ? 1 : 0;
+    add(size, inPsram);
+    return header + 1;
+  }
+
+  void deallocate(void* ptr) override {
+    if (ptr == nullptr) return;
+    Header* header = static_cast<Header*>(ptr) - 1;
+    remove(header->size, header->inPsram != 0);
+    heap_caps_free(header);
+  }
+
+  // Grows in place within the block's region; if that region is full the block
+  // moves to wherever allocate() can place it. Returns nullptr (leaving ptr
+  // valid) only when neither region has room.
+  void* reallocate(void* ptr, size_t newSize) override {
+    if (ptr == nullptr) return allocate(newSize);
+    Header* header = static_cast<Header*>(ptr) - 1;
+    size_t oldSize = header->size;
+    bool inPsram = header->inPsram != 0;
+    uint32_t caps = (inPsram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL) | MALLOC_CAP_8BIT;
+    Header* resized = static_cast<Header*>(heap_caps_realloc(header, sizeof(Header) + newSize, caps));
+    if (resized != nullptr) {
+      remove(oldSize, inPsram);
+      resized->size = (uint32_t)newSize;
+      add(newSize, inPsram);
+      return resized + 1;
+    }
+
+    void* moved = allocate(newSize);
+    if (moved == nullptr) return nullptr;
+    memcpy(moved, ptr, oldSize < newSize ? oldSize : newSize);
+    deallocate(ptr);
+    return moved;
+  }
+
+  const char* name() const { return poolName; }
+  size_t internalBytes() const { return internal.load(std::memory_order_relaxed); }
+  size_t psramBytes() const { return psram.load(std::memory_order_relaxed); }
+  size_t peakBytes() const { return peak.load(std::memory_order_relaxed); }
+  // Allocations that wanted PSRAM but found it full and fell back to internal
+  uint32_t psramFallbacks() const { return fallbacks.load(std::memory_order_relaxed); }
+
+  static bool psramAvailable() {
+    static const bool available = heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0;
+    return available;
+  }
+
+private:
+  struct Header {
+    uint32_t size;
+    uint32_t inPsram;  // Padding keeps the payload 8-byte aligned
+  };
+
+  void add(size_t size, bool inPsram) {
+    (inPsram ? psram : internal).fetch_add(size, std::memory_order_relaxed);
+    size_t total = internalBytes() + psramBytes();
+    size_t seen = peak.load(std::memory_order_relaxed);
+    while (total > seen && !peak.compare_exchange_weak(seen, total, std::memory_order_relaxed)) {
+    }
+  }
+
+  void remove(size_t size, bool inPsram) {
+    (inPsram ? psram : internal).fetch_sub(size, std::memory_order_relaxed);
+  }
+
+  const char* poolName;
+  std::atomic<size_t> internal;
+  std::atomic<size_t> psram;
+  std::atomic<size_t> peak;
+  std::atomic<uint32_t> fallbacks;
+};
+
+// std::allocator adapter so containers (page buffers, encoder scratch) draw from
+// a PsramAllocator. Like the default allocator built without exceptions, running
+// out of memory in both regions aborts.
+template <typename T>
+class PsramStdAllocator {
+public:
+  typedef T value_type;
+
+  explicit PsramStdAllocator(PsramAllocator& pool) : pool(&pool) {}
+  template <typename U>
+  PsramStdAllocator(const PsramStdAllocator<U>& other) : pool(other.pool) {}
+
+  T* allocate(size_t count) {
+    void* memory = pool->allocate(count * sizeof(T));
+    if (memory == nullptr) abort();
+    return static_cast<T*>(memory);
+  }
+
+  void deallocate(T* ptr, size_t) { pool->deallocate(ptr); }
+
+  template <typename U>
+  bool operator==(const PsramStdAllocator<U>& other) const { return pool == other.pool; }
+  template <typename U>
+  bool operator!=(const PsramStdAllocator<U>& other) const { return pool != other.pool; }
+
+private:
+  template <typename U>
+  friend class PsramStdAllocator;
+
+  PsramAllocator* pool;
+};
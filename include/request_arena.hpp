@@ -0,0 +1,177 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include <esp_heap_caps.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "bounded_mpmc_queue.hpp"
+
+// SlabCount equal slabs carved out of one block at boot (PSRAM when present) and
+// never returned to the heap. Arenas borrow slabs through a lock-free free list,
+// so request-scoped memory churns inside this block instead of punching holes in
+// the heap that TLS later needs contiguous.
+template <size_t SlabSize, size_t SlabCount>
+class SlabPool {
+public:
+  SlabPool() : memory(nullptr), overflows(0), peakInUse(0) {}
+
+  SlabPool(const SlabPool&) = delete;
+  SlabPool& operator=(const SlabPool&) = delete;
+
+  // Allocate the backing block; returns false (leaving the pool empty, so every
+  // arena allocation overflows to the heap) if neither region has room
+  bool begin() {
+    memory = static_cast<uint8_t*>(heap_caps_malloc(SlabSize * SlabCount, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (memory == nullptr) {
+      memory = static_cast<uint8_t*>(heap_caps_malloc(SlabSize * SlabCount, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    }
+    if (memory == nullptr) {
+      return false;
+    }
+    for (size_t i = 0; i < SlabCount; i++) {
+      freeSlabs.tryPush(memory + i * SlabSize);
+    }
+    return true;
+  }
+
+  // A free slab, or nullptr when all are lent out
+  uint8_t* acquire() {
+    uint8_t* slab = nullptr;
+    if (!freeSlabs.tryPop(slab)) {
+      return nullptr;
+    }
+    size_t inUse = SlabCount - freeSlabs.sizeApprox();
+    size_t seen = peakInUse.load(std::memory_order_relaxed);
+    while (inUse > seen && !peakInUse.compare_exchange_weak(seen, inUse, std::memory_order_relaxed)) {
+    }
+    return slab;
+  }
+
+  void release(uint8_t* slab) { freeSlabs.tryPush(slab); }
+
+  void noteOverflow() { overflows.fetch_add(1, std::memory_order_relaxed); }
+
+  static size_t slabSize() { return SlabSize; }
+  static size_t slabCount() { return SlabCount; }
+  bool ready() const { return memory != nullptr; }
+  size_t freeCount() const { return freeSlabs.sizeApprox(); }
+  size_t peakSlabsInUse() const { return peakInUse.load(std::memory_order_relaxed); }
+  // Allocations that didn't fit an arena's slabs and went to the heap instead
+  uint32_t overflowCount() const { return overflows.load(std::memory_order_relaxed); }
+
+private:
+  uint8_t* memory;
+  BoundedMpmcQueue<uint8_t*, SlabCount> freeSlabs;
+  std::atomic<uint32_t> overflows;
+  std::atomic<size_t> peakInUse;
+};
+
+// Request-scoped bump allocator over slabs borrowed from a SlabPool. Blocks are
+// never freed individually (except the most recent one, which lets ArduinoJson's
+// string builder grow and shrink in place); every slab goes back to the pool when
+// the arena is destroyed. Allocations that don't fit, or arrive when the pool is
+// dry, go to the overflow allocator and are freed normally. One arena serves one
+// request and is not shared between tasks.
+template <typename Pool>
+class RequestArena : public ArduinoJson::Allocator {
+public:
+  static const size_t MAX_SLABS = 4;  // Cap per request so one big response can't drain the pool
+
+  RequestArena(Pool& pool, ArduinoJson::Allocator& overflow)
+    : pool(pool), overflow(overflow), slabCount(0), used(0), lastBlock(nullptr) {}
+
+  RequestArena(const RequestArena&) = delete;
+  RequestArena& operator=(const RequestArena&) = delete;
+
+  ~RequestArena() {
+    for (size_t i = 0; i < slabCount; i++) {
+      pool.release(slabs[i]);
+    }
+  }
+
+  void* allocate(size_t size) override {
+    size_t need = sizeof(Header) + align(size);
+    bool fits = slabCount > 0 && used + need <= Pool::slabSize();
+    if (need <= Pool::slabSize() && (fits || nextSlab())) {
+      Header* header = reinterpret_cast<Header*>(slabs[slabCount - 1] + used);
+      header->size = (uint32_t)size;
+      used += need;
+      lastBlock = reinterpret_cast<uint8_t*>(header + 1);
+      return lastBlock;
+    }
+    pool.noteOverflow();
+    return overflow.allocate(size);
+  }
+
+  void deallocate(void* ptr) override {
+    if (ptr == nullptr) return;
+    if (!owns(ptr)) {
+      overflow.deallocate(ptr);
+      return;
+    }
+    if (ptr == lastBlock) {
+      used = lastBlock - slabs[slabCount - 1] - sizeof(Header);
+      lastBlock = nullptr;
+    }
+  }
+
+  void* reallocate(void* ptr, size_t newSize) override {
+    if (ptr == nullptr) return allocate(newSize);
+    if (!owns(ptr)) return overflow.reallocate(ptr, newSize);
+
+    Header* header = reinterpret_cast<Header*>(ptr) - 1;
+    if (ptr == lastBlock) {
+      size_t start = lastBlock - slabs[slabCount - 1];
+      if (start + align(newSize) <= Pool::slabSize()) {
+        used = start + align(newSize);
+        header->size = (uint32_t)newSize;
+        return ptr;
+      }
+    } else if (newSize <= header->size) {
+      header->size = (uint32_t)newSize;
+      return ptr;
+    }
+
+    size_t oldSize = header->size;
+    void* moved = allocate(newSize);
+    if (moved == nullptr) return nullptr;
+    memcpy(moved, ptr, oldSize < newSize ? oldSize : newSize);
+    return moved;  // The old block is reclaimed with the arena
+  }
+
+private:
+  struct Header {
+    uint32_t size;
+    uint32_t reserved;  // Keeps payloads 8-byte aligned
+  };
+
+  static size_t align(size_t size) { return (size + 7) & ~(size_t)7; }
+
+  bool nextSlab() {
+    if (slabCount >= MAX_SLABS) return false;
+    uint8_t* slab = pool.acquire();
+    if (slab == nullptr) return false;
+    slabs[slabCount++] = slab;
+    used = 0;
+    lastBlock = nullptr;
+    return true;
+  }
+
+  bool owns(const void* ptr) const {
+    const uint8_t* p = static_cast<const uint8_t*>(ptr);
+    for (size_t i = 0; i < slabCount; i++) {
+      if (p >= slabs[i] && p < slabs[i] + Pool::slabSize()) return true;
+    }
+    return false;
+  }
+
+  Pool& pool;
+  ArduinoJson::Allocator& overflow;
+  uint8_t* slabs[MAX_SLABS];
+  size_t slabCount;
+  size_t used;          // Bytes used in the newest slab
+  uint8_t* lastBlock;   // Most recent allocation in the newest slab, if still live
+};
@@ -0,0 +1,144 @@
+"""
+PlatformIO extra script that reports firmware size per optional feature.
+
+Every build prints which feature switches (FEATURE_* and CHECK_TYPE_* in
+src/main.cpp) are compiled in, together with the flash and RAM totals, and
+writes the same summary to size_report.txt in the build directory.
+
+The feature_sizes target rebuilds the environment once per enabled feature
+with that feature switched off, and reports how much flash and RAM each one
+costs. Variant builds live under .pio/feature_sizes so the normal build is
+left untouched; the first run is a full build per feature, later runs are
+incremental.
+
+Usage:
+    pio run -e heltec-wireless-stick-lite-v3 -t feature_sizes
+"""
+
+import os
+import re
+import subprocess
+
+Import("env")
+
+# Switch name and label, in the order they are reported. All default to 1.
+FEATURES = [
+    ("FEATURE_NTFY", "ntfy"),
+    ("FEATURE_DISCORD", "Discord"),
+    ("FEATURE_SMTP", "SMTP"),
+    ("FEATURE_OTA", "ElegantOTA"),
+    ("FEATURE_DASHBOARD_PAGE", "dashboard page"),
+    ("FEATURE_KIOSK_PAGE", "kiosk page"),
+    ("FEATURE_ADMIN_PAGE", "admin + login pages"),
+    ("CHECK_TYPE_PING", "ping check"),
+    ("CHECK_TYPE_SNMP", "SNMP check"),
+    ("CHECK_TYPE_PORT", "port check"),
+    ("CHECK_TYPE_UPTIME", "uptime check"),
+]
+
+# ESP32 section layout, used when the platform doesn't provide its own patterns
+DEFAULT_PROG_REGEXP = r"^(?:\.iram0\.text|\.iram0\.vectors|\.dram0\.data|\.flash\.text|\.flash\.rodata|)\s+([0-9]+).*"
+DEFAULT_DATA_REGEXP = r"^(?:\.dram0\.data|\.dram0\.bss|\.noinit)\s+([0-9]+).*"
+
+ELF_PATH = "$BUILD_DIR/${PROGNAME}.elf"
+
+
+def feature_states():
+    """Map each switch to True/False from this environment's defines."""
+    defines = {}
+    for define in env.get("CPPDEFINES", []):
+        if isinstance(define, (list, tuple)):
+            defines[str(define[0])] = str(define[1]) if len(define) > 1 else "1"
+        else:
+            name, _, value = str(define).partition("=")
+            defines[name] = value or "1"
+    return {flag: defines.get(flag, "1") not in ("0", "false") for flag, _ in FEATURES}
+
+
+def elf_sizes(elf_path):
+    """Return (flash, ram) bytes for an ELF, or None if the size tool fails."""
+    try:
+        output = subprocess.check_output(
+            [env.subst("$SIZETOOL"), "-A", "-d", elf_path], universal_newlines=True
+        )
+    except (OSError, subprocess.CalledProcessError) as error:
+        print(f"Size report: cannot read {elf_path}: {error}")
+        return None
+
+    prog_pattern = re.compile(env.get("SIZEPROGREGEXP") or DEFAULT_PROG_REGEXP)
+    data_pattern = re.compile(env.get("SIZEDATAREGEXP") or DEFAULT_DATA_REGEXP)
+    flash = ram = 0
+    for line in output.splitlines():
+        match = prog_pattern.search(line)
+        if match:
+            flash += int(match.group(1))
+        match = data_pattern.search(line)
+        if match:
+            ram += int(match.group(1))
+    return flash, ram
+
+
+def write_report(name, lines):
+    path = os.path.join(env.subst("$BUILD_DIR"), name)
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+    for line in lines:
+        print(line)
+    print(f"Size report written to {path}")
+
+
+def report_build(source, target, env):
+    states = feature_states()
+    lines = [f"Feature switches ({env.subst('$PIOENV')}):"]
+    for flag, label in FEATURES:
+        lines.append(f"  {flag:<24} {'on ' if states[flag] else 'off'}  {label}")
+    sizes = elf_sizes(str(target[0]))
+    if sizes:
+        lines.append(f"Firmware: flash {sizes[0]} bytes, RAM {sizes[1]} bytes")
+    write_report("size_report.txt", lines)
+
+
+def report_feature_sizes(source, target, env):
+    baseline = elf_sizes(env.subst(ELF_PATH))
+    if baseline is None:
+        return
+
+    project_dir = env.subst("$PROJECT_DIR")
+    pioenv = env.subst("$PIOENV")
+    states = feature_states()
+    lines = [
+        f"Per-feature size ({pioenv}), saved by building each feature out:",
+        f"  {'feature':<24} {'flash':>9} {'RAM':>9}",
+    ]
+    for flag, label in FEATURES:
+        if not states[flag]:
+            lines.append(f"  {flag:<24} {'-':>9} {'-':>9}  already off")
+            continue
+
+        variant_env = dict(os.environ)
+        variant_env["PLATFORMIO_BUILD_DIR"] = os.path.join(project_dir, ".pio", "feature_sizes", flag)
+        variant_env["PLATFORMIO_BUILD_FLAGS"] = f"-D{flag}=0"
+        print(f"Building {pioenv} without {label} ({flag}=0)...")
+        result = subprocess.call(
+            [env.subst("$PYTHONEXE"), "-m", "platformio", "run", "-s", "-e", pioenv, "-d", project_dir],
+            env=variant_env,
+        )
+        variant_elf = os.path.join(variant_env["PLATFORMIO_BUILD_DIR"], pioenv, env.subst("${PROGNAME}.elf"))
+        sizes = elf_sizes(variant_elf) if result == 0 else None
+        if sizes is None:
+            lines.append(f"  {flag:<24} {'?':>9} {'?':>9}  build failed")
+            continue
+        lines.append(f"  {flag:<24} {baseline[0] - sizes[0]:>9} {baseline[1] - sizes[1]:>9}  {label}")
+    lines.append(f"  {'(total firmware)':<24} {baseline[0]:>9} {baseline[1]:>9}")
+    write_report("feature_sizes.txt", lines)
+
+
+env.AddPostAction(ELF_PATH, report_build)
+
+env.AddCustomTarget(
+    name="feature_sizes",
+    dependencies=ELF_PATH,
+    actions=report_feature_sizes,
+    title="Feature sizes",
+    description="Report the flash and RAM cost of each optional feature",
+)
@@ -7,18 +7,21 @@
 #include <FS.h>
 #include <LittleFS.h>
 #include <HTTPClient.h>
-#include <ESP32Ping.h>
 #include <mbedtls/base64.h>
 #include <mbedtls/sha256.h>
 #include <mbedtls/aes.h>
 #include <mbedtls/md.h>
 #include <WiFiUdp.h>
-#include <SNMP.h>
 #include <regex.h>
 #include <time.h>
 #include <esp_random.h>
-#include <ElegantOTA.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <memory>
 
 // MeshCore layered protocol implementation
 #include "MeshCore.hpp"
@@ -31,7 +34,74 @@
 #define DEBUG_LORA_FORCE_SEND_INTERVAL_MS 30000  // Send test every 30 seconds
 #endif
 
+// Optional check types: set to 0 in build flags to compile a type (and the library
+// behind it) out. HTTP GET and push are always built. See CheckTypes below.
+#ifndef CHECK_TYPE_PING
+#define CHECK_TYPE_PING 1
+#endif
+
+#ifndef CHECK_TYPE_SNMP
+#define CHECK_TYPE_SNMP 1
+#endif
+
+#ifndef CHECK_TYPE_PORT
+#define CHECK_TYPE_PORT 1
+#endif
+
+#ifndef CHECK_TYPE_UPTIME
+#define CHECK_TYPE_UPTIME 1
+#endif
+
+// Optional features: set to 0 in build flags to strip a notification channel, OTA
+// updates or a web UI page, with its code and page markup, from the firmware.
+// `pio run -t feature_sizes` builds each one out in turn and reports what it
+// costs in flash and RAM (see size_report.py).
+#ifndef FEATURE_NTFY
+#define FEATURE_NTFY 1
+#endif
+
+#ifndef FEATURE_DISCORD
+#define FEATURE_DISCORD 1
+#endif
+
+#ifndef FEATURE_SMTP
+#define FEATURE_SMTP 1
+#endif
+
+#ifndef FEATURE_OTA
+#define FEATURE_OTA 1
+#endif
+
+#ifndef FEATURE_DASHBOARD_PAGE
+#define FEATURE_DASHBOARD_PAGE 1  // "/"; redirects to /status when stripped
+#endif
+
+#ifndef FEATURE_KIOSK_PAGE
+#define FEATURE_KIOSK_PAGE 1
+#endif
+
+#ifndef FEATURE_ADMIN_PAGE
+#define FEATURE_ADMIN_PAGE 1  // "/admin" and its login page; the JSON API stays
+#endif
+
+#if CHECK_TYPE_PING
+#include <ESP32Ping.h>
+#endif
+#if CHECK_TYPE_SNMP
+#include <SNMP.h>
+#endif
+#if FEATURE_OTA
+#include <ElegantOTA.h>
+#endif
+
 #include "config.hpp"
+#include "bounded_mpmc_queue.hpp"
+#include "gzip_encoder.hpp"
+#include "id_hash_index.hpp"
+#include "config_string_arena.hpp"
+#include "psram_allocator.hpp"
+#include "request_arena.hpp"
+#include "check_type_registry.hpp"
 
 // Build timestamp (set at compile time)
 #ifndef BUILD_TIMESTAMP
@@ -278,7 +348,8 @@ enum LedStatus {
   LED_STATUS_MESHCORE,     // White - communicating with MeshCore radio
   LED_STATUS_ALL_UP,       // Green pulsing - all services are UP
   LED_STATUS_ANY_DOWN,     // Red pulsing - one or more services are DOWN
-  LED_STATUS_PAUSED_DOWN   // Orange pulsing - paused services are DOWN
+  LED_STATUS_PAUSED_DOWN,  // Orange pulsing - paused services are DOWN
+  LED_STATUS_LOW_MEMORY    // Magenta pulsing - heap too fragmented for a TLS handshake
 };
 
 // Current LED state
@@ -313,7 +384,8 @@ void updateLed() {
   bool shouldPulse = (currentLedStatus == LED_STATUS_BOOTING ||
                       currentLedStatus == LED_STATUS_ALL_UP ||
                       currentLedStatus == LED_STATUS_ANY_DOWN ||
-                      currentLedStatus == LED_STATUS_PAUSED_DOWN);
+                      currentLedStatus == LED_STATUS_PAUSED_DOWN ||
+                      currentLedStatus == LED_STATUS_LOW_MEMORY);
   
   if (shouldPulse) {
     if (ledPulseDirection) {
@@ -367,6 +439,11 @@ void updateLed() {
       r = ledBrightness;
       g = ledBrightness / 3;  // Orange = red + some green
       break;
+    case LED_STATUS_LOW_MEMORY:
+      // Magenta pulsing - HTTPS alerts are about to start failing
+      r = ledBrightness;
+      b = ledBrightness;
+      break;
   }
 
   neopixelWrite(RGB_BUILTIN, r, g, b);
@@ -385,16 +462,17 @@ void setLedStatus(LedStatus status) {
   }
 }
 
+// A channel stripped at build time reads as unconfigured, so it is never queued or sent
 bool isNtfyConfigured() {
-  return strlen(NTFY_TOPIC) > 0;
+  return FEATURE_NTFY && strlen(NTFY_TOPIC) > 0;
 }
 
 bool isDiscordConfigured() {
-  return strlen(DISCORD_WEBHOOK_URL) > 0;
+  return FEATURE_DISCORD && strlen(DISCORD_WEBHOOK_URL) > 0;
 }
 
 bool isSmtpConfigured() {
-  return strlen(SMTP_SERVER) > 0 && strlen(SMTP_FROM_ADDRESS) > 0 &&
+  return FEATURE_SMTP && strlen(SMTP_SERVER) > 0 && strlen(SMTP_FROM_ADDRESS) > 0 &&
          strlen(SMTP_TO_ADDRESS) > 0;
 }
 
@@ -428,6 +506,11 @@ void reconnectWiFi();
 
 AsyncWebServer server(80);
 
+// Server-Sent Events channel for live status pushes.
+// Pages subscribe once and receive compact deltas instead of polling 1 + N APIs.
+// Lives under /api/stream rather than /api/events/ so the event-log wildcard doesn't capture it.
+AsyncEventSource statusEvents("/api/stream");
+
 // MeshCore Protocol Stack (layered architecture)
 // The transport layer varies based on hardware:
 // - BLE mode (default): BLECentralTransport connects to external MeshCore device
@@ -1117,16 +1200,16 @@ int getMeshProtocolState() {
 // Mutex for protecting services array access
 SemaphoreHandle_t servicesMutex = NULL;
 
-// Service types
-// Right now the behavior for each is rudimentary
-// However, you can use this to expand and add services with more complex checks
+// Service types. Values are persisted in services.json, so never renumber them.
+// Names, flags and probes live in the CheckTypes registry; a type compiled out of
+// the registry keeps its value here.
 enum ServiceType {
-  TYPE_HTTP_GET,
-  TYPE_PING,
-  TYPE_SNMP_GET,
-  TYPE_PORT,
-  TYPE_PUSH,
-  TYPE_UPTIME
+  TYPE_HTTP_GET = 0,
+  TYPE_PING = 1,
+  TYPE_SNMP_GET = 2,
+  TYPE_PORT = 3,
+  TYPE_PUSH = 4,
+  TYPE_UPTIME = 5
 };
 
 // SNMP comparison operators for value checks
@@ -1139,16 +1222,68 @@ enum SnmpCompareOp {
   SNMP_OP_GE     // Greater than or equal (>=)
 };
 
+// Failure classes for check results, counted per service and exported by /metrics
+enum CheckError {
+  CHECK_OK,
+  CHECK_ERR_CONFIG,       // Missing/invalid URL, regex or operator
+  CHECK_ERR_DNS,          // Hostname did not resolve
+  CHECK_ERR_CONNECT,      // Connection refused/failed, request could not be sent
+  CHECK_ERR_TIMEOUT,      // No reply in time (ping, SNMP)
+  CHECK_ERR_HTTP_STATUS,  // Unexpected HTTP status code
+  CHECK_ERR_MISMATCH,     // Response, value or uptime did not match the expectation
+  CHECK_ERR_NO_PUSH,      // Push not received within the interval
+  CHECK_ERR_PUSH_DOWN,    // Push reported status=down
+  CHECK_ERR_INTERNAL,     // Local resource failure
+  CHECK_ERROR_COUNT
+};
+
+// Check latency histogram: fixed upper bounds in ms, the last bucket is +Inf.
+// Fed by active check durations and by duration= on push requests.
+const int LATENCY_BUCKET_COUNT = 8;
+const uint32_t LATENCY_BUCKET_BOUNDS_MS[LATENCY_BUCKET_COUNT - 1] = {50, 100, 250, 500, 1000, 2500, 5000};
+
+struct LatencyHistogram {
+  uint32_t buckets[LATENCY_BUCKET_COUNT];  // Per-bucket (non-cumulative) counts
+  uint32_t count;
+  uint64_t sumMs;
+  uint32_t lastMs;
+};
+
+// Check target config strings, stored together in Service::config (see
+// ConfigStringArena) instead of as separate Strings: one allocation per service,
+// shared by every copy (snapshots, the checker's working copy) until an edit
+enum ServiceConfigField {
+  CFG_HOST,
+  CFG_PATH,
+  CFG_URL,                  // Full URL for HTTP GET (http:// or https://)
+  CFG_EXPECTED_RESPONSE,
+  CFG_SNMP_OID,             // SNMP OID to query (e.g., "1.3.6.1.2.1.1.1.0")
+  CFG_SNMP_COMMUNITY,       // SNMP community string (default: "public")
+  CFG_SNMP_EXPECTED_VALUE,  // Expected value for SNMP/push value comparison
+  SERVICE_CONFIG_FIELD_COUNT
+};
+
+typedef ConfigStringArena<SERVICE_CONFIG_FIELD_COUNT> ServiceConfigStrings;
+
+// Immutable, pre-parsed check configuration, defined after Service
+struct CheckPlan;
+typedef std::shared_ptr<const CheckPlan> CheckPlanRef;
+
+// Immutable copy of a service's configuration for snapshot readers, defined after Service
+struct ServiceInfo;
+typedef std::shared_ptr<const ServiceInfo> ServiceInfoRef;
+
 // Service structure
 struct Service {
   String id;
   String name;
+  String tags;            // Comma-separated labels for grouping and ?tag= filtering
+  String group;           // Service group ("" = none); status is aggregated per group
   ServiceType type;
-  String host;
+  ServiceConfigStrings config;  // Indexed by ServiceConfigField
+  CheckPlanRef plan;      // Compiled from the fields above when the service is saved
+  ServiceInfoRef info;    // Built from the config fields by markServiceConfigChanged()
   int port;
-  String path;
-  String url;             // Full URL for HTTP GET (http:// or https://)
-  String expectedResponse;
   int checkInterval;
   int passThreshold;      // Number of consecutive passes required to mark as UP
   int failThreshold;      // Number of consecutive fails required to mark as DOWN
@@ -1161,21 +1296,131 @@ struct Service {
   unsigned long lastCheck;
   unsigned long lastUptime;
   String lastError;
+  CheckError lastErrorCode; // Failure class of lastError
   int secondsSinceLastCheck;
   // SNMP-specific fields
-  String snmpOid;         // SNMP OID to query (e.g., "1.3.6.1.2.1.1.1.0")
-  String snmpCommunity;   // SNMP community string (default: "public")
   SnmpCompareOp snmpCompareOp;  // Comparison operator for SNMP value check
-  String snmpExpectedValue;     // Expected value for comparison
   // Uptime-specific fields
   int uptimeThreshold;          // Uptime threshold in seconds
   SnmpCompareOp uptimeCompareOp; // Comparison operator for uptime check
   // Push-specific fields
   String pushToken;       // Unique token for push endpoint (for TYPE_PUSH)
   unsigned long lastPush; // Timestamp of last push received (millis)
+  bool lastPushFailed;    // Last push reported status=down or a value outside the threshold
+  String lastPushMessage; // msg= from the last push
+  // Telemetry from active checks and push payloads
+  LatencyHistogram latency;
+  float lastValue;        // Last value= received by push (valid when hasValue)
+  bool hasValue;
+  uint32_t checksTotal;   // Check results applied since boot
+  uint32_t checksFailed;
+  uint32_t errorCounts[CHECK_ERROR_COUNT];  // Failed checks by CheckError
   // Enable/disable and pause fields
   bool enabled;           // Whether service checks are enabled
   unsigned long pauseUntil; // Timestamp (millis) until which checks are paused (0 = not paused)
+  // Change tracking
+  uint32_t changeVersion; // statusVersion value at this service's last config or state change
+  uint32_t configVersion; // changeVersion of the last config edit (keys the cached config JSON)
+  int8_t groupSlot;       // Index into GroupAggregates::groups, -1 if ungrouped
+  uint8_t aggregateState; // AggregateState this service is currently counted under
+};
+
+// The configuration fields of a Service, as the lock-free readers see them (see
+// StatusSnapshot). Built whenever the config is added, edited or loaded and never
+// modified afterwards; services[] and both snapshot buffers share one copy, so a
+// status publish only moves a reference.
+struct ServiceInfo {
+  String id;
+  String name;
+  String tags;
+  String group;
+  ServiceType type;
+  ServiceConfigStrings config;  // Shares the service's string block
+  int port;
+  int checkInterval;
+  int passThreshold;
+  int failThreshold;
+  int rearmCount;
+  SnmpCompareOp snmpCompareOp;
+  int uptimeThreshold;
+  SnmpCompareOp uptimeCompareOp;
+  String pushToken;
+};
+
+inline ServiceInfoRef makeServiceInfo(const Service& service) {
+  std::shared_ptr<ServiceInfo> info(new ServiceInfo());
+  info->id = service.id;
+  info->name = service.name;
+  info->tags = service.tags;
+  info->group = service.group;
+  info->type = service.type;
+  info->config = service.config;
+  info->port = service.port;
+  info->checkInterval = service.checkInterval;
+  info->passThreshold = service.passThreshold;
+  info->failThreshold = service.failThreshold;
+  info->rearmCount = service.rearmCount;
+  info->snmpCompareOp = service.snmpCompareOp;
+  info->uptimeThreshold = service.uptimeThreshold;
+  info->uptimeCompareOp = service.uptimeCompareOp;
+  info->pushToken = service.pushToken;
+  return info;
+}
+
+// How an HTTP GET check judges the response body
+enum ResponseMatchMode {
+  MATCH_ANY,        // expectedResponse "*": any 200 passes
+  MATCH_SUBSTRING,  // Body must contain expectedResponse
+  MATCH_REGEX       // "regex:" prefix, compiled once into CheckPlan::regex
+};
+
+// Everything an active check reads from a service, parsed once by
+// compileCheckPlan() when the service is saved. Plans are never modified after
+// compilation: the checker holds a CheckPlanRef for the duration of a check
+// instead of copying the Service, and an edit installs a new plan, so a check in
+// flight keeps the one it started with.
+struct CheckPlan {
+  CheckPlan()
+    : type(TYPE_HTTP_GET), port(0), configError(CHECK_OK), configErrorText(""), isSecure(false),
+      matchMode(MATCH_ANY), regexCompiled(false), hostIsAddress(false), snmpCompareOp(SNMP_OP_EQ), expectedIsNumeric(false),
+      expectedNumber(0), uptimeThreshold(0), uptimeCompareOp(SNMP_OP_GT) {}
+  ~CheckPlan() {
+    if (regexCompiled) {
+      regfree(&regex);
+    }
+  }
+  CheckPlan(const CheckPlan&) = delete;
+  CheckPlan& operator=(const CheckPlan&) = delete;
+
+  String serviceId;              // Used to find the service again when applying the result
+  String serviceName;
+  ServiceType type;
+  ServiceConfigStrings config;   // Shares the service's string block
+  int port;
+  CheckError configError;        // CHECK_ERR_CONFIG when the config can never pass
+  const char* configErrorText;
+  // HTTP GET
+  bool isSecure;                 // URL starts with https://
+  ResponseMatchMode matchMode;
+  regex_t regex;                 // Valid when regexCompiled
+  bool regexCompiled;            // Freed on that flag alone; configError may be set for other reasons
+  // Ping, port and SNMP: IP literals are parsed here; host names are resolved per check
+  bool hostIsAddress;
+  IPAddress hostAddress;
+  // SNMP
+  SnmpCompareOp snmpCompareOp;
+  bool expectedIsNumeric;        // snmpExpectedValue parsed as a number
+  float expectedNumber;
+  // Uptime
+  int uptimeThreshold;
+  SnmpCompareOp uptimeCompareOp;
+};
+
+// Result of one active check, passed on to the aggregator as a CheckResultRecord
+struct CheckOutcome {
+  CheckOutcome() : code(CHECK_OK) {}
+  CheckError code;
+  String error;
 };
 
 // Historical data structure for uptime tracking
@@ -1188,6 +1433,7 @@ struct ServiceHistory {
   int checksThisHour;                  // Number of checks performed this hour
   int passesThisHour;                  // Number of successful checks this hour
   unsigned long currentHourStart;      // Timestamp (seconds) of current hour being tracked
+  uint32_t version;                    // historyVersion value when hourlyUptime last changed
 };
 
 // Event log structure for detailed up/down state changes
@@ -1202,16 +1448,44 @@ struct ServiceEventLog {
   std::vector<ServiceEvent> events;
 };
 
-// Store up to 20 services
-const int MAX_SERVICES = 20;
-Service services[MAX_SERVICES];
+// Service capacity; boards with PSRAM can raise it with -DMAX_SERVICES_LIMIT=<n>
+#ifndef MAX_SERVICES_LIMIT
+#define MAX_SERVICES_LIMIT 20
+#endif
+const int MAX_SERVICES = MAX_SERVICES_LIMIT;
+
+// Per-service tables are allocated once in setup() by allocateServiceStorage(),
+// from PSRAM when the board has it, so MAX_SERVICES doesn't cost static DRAM
+Service* services = nullptr;
 int serviceCount = 0;
 
-// Historical data for all services
-ServiceHistory serviceHistories[MAX_SERVICES];
+// Hot scheduling fields mirrored from services[] (same index) into a dense array,
+// so the scheduler scan in checkServices() reads 16 bytes per service instead of
+// pulling every Service struct through the cache. services[] stays authoritative:
+// entries are refreshed with the id index on every list/config change and by the
+// checker itself, and a due entry is re-checked against services[] before use.
+struct ServiceSchedule {
+  unsigned long lastCheck;
+  unsigned long pauseUntil;
+  uint32_t intervalMs;
+  bool enabled;
+};
+
+ServiceSchedule* serviceSchedules = nullptr;
+
+// Historical data for all services (slots are stable for a service's lifetime)
+ServiceHistory* serviceHistories = nullptr;
 
-// Event logs for all services
-ServiceEventLog serviceEventLogs[MAX_SERVICES];
+// Event logs for all services (slots are stable for a service's lifetime)
+ServiceEventLog* serviceEventLogs = nullptr;
+
+// Hash indexes from service id to table position, so lookups by id don't scan
+// and compare every String. serviceIdIndex maps to the services[] position and is
+// rebuilt with the push token index whenever the list changes (under servicesMutex);
+// the history and event log indexes map to their fixed slots and are updated in place.
+IdHashIndex serviceIdIndex;
+IdHashIndex historyIdIndex;
+IdHashIndex eventLogIdIndex;
 
 // Historical data constants
 const int MAX_HISTORY_HOURS = 720;  // 30 days of hourly data per service (720 bytes/service)
@@ -1221,6 +1495,211 @@ const int MAX_MISSED_HOURS_TO_FILL = 24;  // Maximum gap to backfill with 0% upt
 // Event log constants
 const int MAX_EVENTS_PER_SERVICE = 100;  // Keep last 100 events per service
 
+// Change tracking for conditional GET (ETag / If-None-Match)
+// statusVersion is bumped whenever any service's config or runtime state changes,
+// historyVersion whenever any hourly uptime bucket is finalized or cleared.
+// Both only ever increase within a boot, so with statusBootEpoch (see makeEtag())
+// they double as strong ETags for the JSON APIs.
+std::atomic<uint32_t> statusVersion(1);
+std::atomic<uint32_t> historyVersion(1);
+
+// Service groups: each service names at most one group (Service::group). The
+// number of services in each AggregateState is kept per group and in total, and
+// moved one service at a time as state changes (markServiceChanged() ->
+// refreshServiceAggregate()), so "is anything down?" is a table read for the LED,
+// LCD, status page, /api/groups and notifications instead of a scan over every
+// service. rebuildGroupAggregates() recounts from scratch on list/config changes.
+const int MAX_SERVICE_GROUPS = 16;
+const int MAX_GROUP_NAME_LENGTH = 31;
+
+// Every service is counted in exactly one bucket
+enum AggregateState {
+  AGG_UNKNOWN,      // Enabled and not paused, but not checked yet
+  AGG_UP,
+  AGG_DOWN,
+  AGG_PAUSED,       // Paused while up (or not checked yet)
+  AGG_PAUSED_DOWN,  // Paused while down
+  AGG_DISABLED,
+  AGG_STATE_COUNT
+};
+
+struct GroupStatus {
+  char name[MAX_GROUP_NAME_LENGTH + 1];  // "" for the all-services totals
+  uint16_t counts[AGG_STATE_COUNT];
+};
+
+struct GroupAggregates {
+  GroupStatus totals;
+  GroupStatus groups[MAX_SERVICE_GROUPS];
+  int groupCount;
+};
+
+// Live counts, guarded by servicesMutex; lock-free readers use StatusSnapshot::groups
+GroupAggregates groupAggregates;
+
+void refreshServiceAggregate(Service& service);
+
+// Stamp a service as changed; returns the new global status version
+inline uint32_t markServiceChanged(Service& service) {
+  service.changeVersion = ++statusVersion;
+  refreshServiceAggregate(service);
+  return service.changeVersion;
+}
+
+// Stamp a service whose configuration (not just its state) was added, edited or loaded
+inline uint32_t markServiceConfigChanged(Service& service) {
+  service.info = makeServiceInfo(service);
+  service.configVersion = markServiceChanged(service);
+  return service.configVersion;
+}
+
+// Stamp a service history as changed (new or cleared hourly bucket)
+inline uint32_t markHistoryChanged(ServiceHistory& history) {
+  history.version = ++historyVersion;
+  return history.version;
+}
+
+// Change feed (GET /api/services?since=<version>&epoch=<epoch>)
+// Deleted services leave a tombstone so delta clients can drop them. The ring is
+// small; once a tombstone is overwritten, clients older than its version get a
+// full list instead. statusBootEpoch changes every boot because statusVersion
+// restarts from 1, so versions from a previous boot must never be compared.
+const int MAX_SERVICE_TOMBSTONES = 16;
+
+struct ServiceTombstone {
+  String id;
+  uint32_t version;
+};
+
+ServiceTombstone serviceTombstones[MAX_SERVICE_TOMBSTONES];
+int serviceTombstoneNext = 0;
+uint32_t serviceTombstoneFloor = 0;  // Version of the newest tombstone that has been overwritten
+uint32_t statusBootEpoch = 0;
+
+// Server-side projection/filtering for GET /api/services:
+//   fields=id,name,isUp   only emit these keys per service
+//   status=down,paused    up | down | paused | pending | disabled
+//   type=http_get,ping    service type strings as in the JSON
+//   tag=prod              services carrying any of the listed tags
+//   group=core            services in any of the listed groups
+//   sort=name             name | status | type | id, prefix '-' for descending
+struct ServiceQuery {
+  std::vector<String> fields;   // Empty = all fields
+  std::vector<String> statuses;
+  std::vector<String> types;
+  std::vector<String> tags;
+  std::vector<String> groups;
+  String sortKey;
+  bool sortDescending;
+  bool filtered;                // Any status/type/tag/group filter present
+};
+
+// One service as lock-free readers see it: the runtime fields they show, plus the
+// shared configuration. Fixed size, so refreshing an entry allocates nothing;
+// lastError and lastPushMessage are cut to what check results and pushes carry.
+struct ServiceStatus {
+  ServiceInfoRef info;
+  int consecutivePasses;
+  int consecutiveFails;
+  int failedChecksSinceAlert;
+  bool isUp;
+  unsigned long lastCheck;
+  char lastError[96];        // As CheckResultRecord::error
+  char lastPushMessage[64];  // As PushEvent::message
+  LatencyHistogram latency;
+  float lastValue;
+  bool hasValue;
+  uint32_t checksTotal;
+  uint32_t checksFailed;
+  uint32_t errorCounts[CHECK_ERROR_COUNT];
+  bool enabled;
+  unsigned long pauseUntil;
+  uint32_t changeVersion;
+  uint32_t configVersion;
+};
+
+// Double-buffered status of services[] for lock-free readers (web handlers, LED, LCD, metrics).
+// Readers pin the active buffer with StatusSnapshotReader and never touch servicesMutex.
+// Writers call publishStatusSnapshot() while holding servicesMutex: it waits for any
+// stragglers on the inactive buffer, refreshes only the entries whose changeVersion
+// moved, and flips the active index. changeVersion values are unique across services,
+// so an unchanged version means the copy is already current.
+struct StatusSnapshot {
+  ServiceStatus* services;  // MAX_SERVICES entries, see allocateServiceStorage()
+  int count;
+  GroupAggregates groups;  // Counts matching services[] at publish time
+  uint32_t version;  // statusVersion at publish time
+};
+
+StatusSnapshot statusSnapshots[2];
+std::atomic<int> activeSnapshot(0);
+std::atomic<int> snapshotReaders[2];
+
+static void copyServiceStatus(ServiceStatus& status, const Service& service) {
+  status.info = service.info;
+  status.consecutivePasses = service.consecutivePasses;
+  status.consecutiveFails = service.consecutiveFails;
+  status.failedChecksSinceAlert = service.failedChecksSinceAlert;
+  status.isUp = service.isUp;
+  status.lastCheck = service.lastCheck;
+  strncpy(status.lastError, service.lastError.c_str(), sizeof(status.lastError) - 1);
+  status.lastError[sizeof(status.lastError) - 1] = '\0';
+  strncpy(status.lastPushMessage, service.lastPushMessage.c_str(), sizeof(status.lastPushMessage) - 1);
+  status.lastPushMessage[sizeof(status.lastPushMessage) - 1] = '\0';
+  status.latency = service.latency;
+  status.lastValue = service.lastValue;
+  status.hasValue = service.hasValue;
+  status.checksTotal = service.checksTotal;
+  status.checksFailed = service.checksFailed;
+  memcpy(status.errorCounts, service.errorCounts, sizeof(status.errorCounts));
+  status.enabled = service.enabled;
+  status.pauseUntil = service.pauseUntil;
+  status.changeVersion = service.changeVersion;
+  status.configVersion = service.configVersion;
+}
+
+// Caller holds servicesMutex (or runs before other tasks start)
+void publishStatusSnapshot() {
+  int next = 1 - activeSnapshot.load();
+  while (snapshotReaders[next].load() > 0) {
+    vTaskDelay(1);  // A reader that pinned this buffer before the last flip is finishing
+  }
+
+  StatusSnapshot& snapshot = statusSnapshots[next];
+  for (int i = 0; i < serviceCount; i++) {
+    if (i >= snapshot.count || snapshot.services[i].changeVersion != services[i].changeVersion) {
+      copyServiceStatus(snapshot.services[i], services[i]);
+    }
+  }
+  snapshot.count = serviceCount;
+  snapshot.groups = groupAggregates;
+  snapshot.version = statusVersion.load();
+  activeSnapshot.store(next);
+}
+
+// RAII pin on the current snapshot; keep it scoped to a single handler call
+class StatusSnapshotReader {
+public:
+  StatusSnapshotReader() {
+    for (;;) {
+      index = activeSnapshot.load();
+      snapshotReaders[index]++;
+      if (activeSnapshot.load() == index) break;
+      snapshotReaders[index]--;  // Flipped while pinning; retry on the new buffer
+    }
+  }
+  ~StatusSnapshotReader() { snapshotReaders[index]--; }
+
+  StatusSnapshotReader(const StatusSnapshotReader&) = delete;
+  StatusSnapshotReader& operator=(const StatusSnapshotReader&) = delete;
+
+  const StatusSnapshot* operator->() const { return &statusSnapshots[index]; }
+  const StatusSnapshot& operator*() const { return statusSnapshots[index]; }
+
+private:
+  int index;
+};
+
 // Filesystem readiness flag to avoid LittleFS access before mount
 static bool littleFsReady = false;
 
@@ -1230,6 +1709,368 @@ const int PORT_CHECK_TIMEOUT_MS = 5000;  // TCP connection timeout for port chec
 // Push check constants
 const unsigned long PUSH_TIMING_MARGIN_MS = 5000;  // Margin for push timing checks
 
+// Push token index: hash of token to services[] index so /api/push/* doesn't scan
+// and compare every token. Rebuilt from saveServices()/loadServices(); every caller
+// of those runs either in setup() or on the async web server task, which is also
+// the only reader.
+IdHashIndex pushTokenIndex;
+
+// Pushes accepted by the web handler and waiting for the aggregator task to apply them.
+// The handler never takes servicesMutex; the service is re-validated by token
+// hash when the event is applied in case it was edited or deleted meanwhile.
+struct PushEvent {
+  int16_t serviceIndex;
+  uint32_t tokenHash;
+  unsigned long receivedAt;
+  bool reportedDown;       // status=down
+  bool hasValue;           // value= present
+  bool hasDuration;        // duration= present
+  float value;
+  uint32_t durationMs;
+  char valueText[24];      // value= as sent, for the threshold comparison
+  char message[64];        // msg=, truncated to fit
+};
+
+const size_t PUSH_QUEUE_CAPACITY = 32;
+BoundedMpmcQueue<PushEvent, PUSH_QUEUE_CAPACITY> pushQueue;
+
+// Check results handed from the check executor (checkServices()) to the
+// aggregator task. The executor never takes servicesMutex to report a result;
+// the slot is re-validated by id hash when the record is applied, and looked up
+// again through the id index if services were deleted meanwhile.
+struct CheckResultRecord {
+  int16_t serviceIndex;     // services[] slot when the check started
+  uint32_t idHash;          // fnv1aHash of the service id
+  unsigned long checkedAt;  // millis() stamped into lastCheck when the check started
+  uint32_t durationMs;
+  CheckError errorCode;
+  bool passed;
+  bool hasLatency;          // Active network check (not push/uptime bookkeeping)
+  char error[96];           // CheckOutcome::error, truncated to fit
+};
+
+const size_t CHECK_RESULT_QUEUE_CAPACITY = 32;
+BoundedMpmcQueue<CheckResultRecord, CHECK_RESULT_QUEUE_CAPACITY> checkResultQueue;
+
+// Up/down notifications decided by the aggregator and sent from the probe task, which
+// owns notificationQueue[] and does the notifier I/O without holding servicesMutex
+struct AlertRequest {
+  int16_t serviceIndex;
+  uint32_t idHash;
+  bool isUp;
+};
+
+const size_t ALERT_QUEUE_CAPACITY = 32;
+BoundedMpmcQueue<AlertRequest, ALERT_QUEUE_CAPACITY> alertQueue;
+
+// Task layout. The S3 has two cores; the WiFi driver and lwIP already live on
+// core 0 and the Arduino loop task on core 1 (ARDUINO_RUNNING_CORE).
+//   core 0  "probe"      service checks, up/down notifications, the retry and
+//                        MeshCore queues, LoRa polling. It spends most of its time
+//                        blocked in socket I/O, next to the network stack it waits on.
+//   core 0  async_tcp    the web server, pinned by CONFIG_ASYNC_TCP_RUNNING_CORE in
+//                        platformio.ini at a higher priority than the probe task so
+//                        pages stay responsive while checks run
+//   core 1  loopTask     LED, display and touch, static status page, OTA
+//   core 1  "aggregator" applies check results and pushes (see below)
+// Cores, priorities and stack sizes can be overridden with -D build flags.
+#ifndef PROBE_TASK_CORE
+#define PROBE_TASK_CORE 0
+#endif
+#ifndef PROBE_TASK_PRIORITY
+#define PROBE_TASK_PRIORITY 1
+#endif
+#ifndef PROBE_TASK_STACK_SIZE
+#define PROBE_TASK_STACK_SIZE 12288  // TLS handshakes (HTTPS checks, SMTP) run on this stack
+#endif
+#ifndef AGGREGATOR_TASK_CORE
+#define AGGREGATOR_TASK_CORE 1
+#endif
+#ifndef AGGREGATOR_TASK_PRIORITY
+#define AGGREGATOR_TASK_PRIORITY 1
+#endif
+#ifndef AGGREGATOR_TASK_STACK_SIZE
+#define AGGREGATOR_TASK_STACK_SIZE 8192
+#endif
+const uint32_t PROBE_TASK_IDLE_MS = 10;                // Sleep between probe passes
+const unsigned long CHECK_INTERVAL_MS = 5000;          // How often checkServices() runs
+TaskHandle_t probeTaskHandle = nullptr;
+bool hasPerformedChecks = false;  // Set by the probe task; the LED shows "booting" until then
+
+// State aggregator task: the single writer of service state machines, history
+// rollups and event logs. It sleeps until a producer (checkServices() or the push
+// handler) notifies it, drains pushQueue and checkResultQueue in batches with one
+// servicesMutex hold per batch, and is the only task that writes history.json and
+// event_logs.json. Web handlers that change either set a flag and wake it.
+const uint32_t AGGREGATOR_IDLE_WAKE_MS = 1000;        // Wake anyway to run periodic work
+const unsigned long HISTORY_SAVE_INTERVAL_MS = 300000;  // 5 minutes
+TaskHandle_t aggregatorTaskHandle = nullptr;
+std::atomic<bool> eventLogsDirty(false);       // Set by recordServiceEvent() and removals
+std::atomic<bool> historySaveRequested(false);  // Set when history is cleared or removed
+
+// Web request admission control
+// Every heavy handler calls admitRequest() first (body handlers call admitBody()).
+// A request is refused when its client is over its token bucket (429), when heap
+// is below the class threshold (503), or when the class is at its concurrency
+// limit (503). /api/stream connects go through admitStreamConnect() instead: an
+// SSE client holds its buffers for as long as it stays connected, so its class
+// limit caps open streams rather than requests in flight.
+// All handlers run on the async_tcp task, so this state needs no locking.
+enum RequestClass {
+  REQ_PAGE,       // HTML pages (tens of KB each)
+  REQ_API_READ,   // JSON reads: services, histories, events, export
+  REQ_API_WRITE,  // Authenticated config changes
+  REQ_LOGIN,      // Credential checks; rate-limited by their own buckets
+  REQ_PUSH,       // Push heartbeats
+  REQ_METRICS,    // /metrics scrapes
+  REQ_STREAM,     // /api/stream (SSE) connects
+  REQ_CLASS_COUNT
+};
+
+enum AdmissionReject {
+  REJECT_RATE,         // Client token bucket empty (429)
+  REJECT_HEAP,         // Free or largest-block heap below threshold (503)
+  REJECT_CONCURRENCY,  // Too many requests of this class in flight (503)
+  REJECT_PRESSURE,     // Shed at the current memory pressure level (503)
+  REJECT_REASON_COUNT
+};
+
+struct AdmissionPolicy {
+  const char* name;
+  uint8_t maxInFlight;       // 0 = unlimited (body handlers can't reliably release a slot)
+  uint32_t minFreeHeap;      // bytes
+  uint32_t minLargestBlock;  // bytes
+};
+
+const AdmissionPolicy ADMISSION_POLICIES[REQ_CLASS_COUNT] = {
+  {"page",      2, 40 * 1024, 24 * 1024},
+  {"api_read",  4, 32 * 1024, 16 * 1024},
+  {"api_write", 0, 24 * 1024,  8 * 1024},
+  {"login",     0, 24 * 1024,  8 * 1024},
+  {"push",      0, 16 * 1024,  4 * 1024},
+  {"metrics",   1, 24 * 1024,  8 * 1024},
+  {"stream",    4, 40 * 1024, 16 * 1024},
+};
+
+// Per-client token buckets (LRU table keyed by IPv4 address)
+const int CLIENT_BUCKET_COUNT = 16;
+const float CLIENT_BUCKET_CAPACITY = 30.0f;        // Burst size
+const float CLIENT_BUCKET_REFILL_PER_SEC = 10.0f;  // Sustained requests per second
+const int ADMISSION_RETRY_AFTER_SECONDS = 5;
+
+// Longest a web handler waits for servicesMutex. Every request and the SSE stream
+// share the async_tcp task, so past this the client gets 503 + Retry-After instead.
+const TickType_t WEB_LOCK_TIMEOUT = pdMS_TO_TICKS(100);
+
+struct ClientBucket {
+  uint32_t ip;             // 0 = unused
+  float tokens;
+  unsigned long lastRefill;
+};
+
+ClientBucket clientBuckets[CLIENT_BUCKET_COUNT];
+
+// Login attempts draw from separate, much smaller buckets, so password guessing is
+// throttled hard without eating into the client's budget for other requests
+const float LOGIN_BUCKET_CAPACITY = 5.0f;
+const float LOGIN_BUCKET_REFILL_PER_SEC = 0.2f;  // One attempt per 5 seconds sustained
+ClientBucket loginBuckets[CLIENT_BUCKET_COUNT];
+
+int requestsInFlight[REQ_CLASS_COUNT];
+uint32_t admissionRejections[REQ_CLASS_COUNT][REJECT_REASON_COUNT];
+
+// Admin sessions: POST /api/login trades the configured credentials for a cookie
+// "session=<expiry>.<nonce>.<mac>", where mac is HMAC-SHA256 over the generation,
+// expiry and nonce. The key is random per boot (a reboot ends every session), and
+// logging out bumps the generation, which invalidates every outstanding cookie.
+const uint32_t SESSION_TTL_SECONDS = 12UL * 60UL * 60UL;  // 12 hours
+const char* SESSION_COOKIE_NAME = "session";
+mbedtls_md_context_t sessionHmac;  // Keyed once in initSessions(), reset per token
+uint32_t sessionGeneration = 0;
+
+// Per-task busy time, exported by /metrics. A pass is one wake-up of the task;
+// time spent waiting for work (the trailing delay, a task notification) is
+// excluded, time blocked in a probe's socket I/O is not, so the probe figure is
+// an upper bound on its CPU use.
+enum TaskSlot {
+  TASK_LOOP,
+  TASK_PROBE,
+  TASK_AGGREGATOR,
+  TASK_SLOT_COUNT
+};
+
+struct TaskStats {
+  const char* name;
+  int8_t core;              // Core of the latest pass, -1 until the task has run
+  uint32_t passes;
+  uint64_t busyMicros;
+  uint32_t lastMicros;
+  uint32_t maxMicros;
+  uint32_t stackFreeBytes;  // Stack high-water mark, sampled every TASK_STACK_SAMPLE_PASSES
+};
+
+const uint32_t TASK_STACK_SAMPLE_PASSES = 100;
+TaskStats taskStats[TASK_SLOT_COUNT] = {
+  {"loop", -1, 0, 0, 0, 0, 0},
+  {"probe", -1, 0, 0, 0, 0, 0},
+  {"aggregator", -1, 0, 0, 0, 0, 0},
+};
+portMUX_TYPE taskStatsMux = portMUX_INITIALIZER_UNLOCKED;  // Each task writes its slot, /metrics copies all
+
+// Heap pools, one per subsystem. Every JsonDocument names the pool it draws from
+// and the static page keeps its buffers in pageMemory, so documents land in PSRAM
+// on boards that have it and /metrics can show who holds internal vs PSRAM bytes.
+PsramAllocator apiMemory("api");          // Web request and response documents
+PsramAllocator configMemory("config");    // services.json, export and import
+PsramAllocator historyMemory("history");  // history.json and /api/history
+PsramAllocator eventMemory("events");     // events.json and /api/events
+PsramAllocator streamMemory("stream");    // Server-Sent Event payloads
+PsramAllocator notifyMemory("notify");    // Outgoing notification payloads
+PsramAllocator pageMemory("pages");       // Static status page render and gzip buffers
+PsramAllocator fragmentMemory("fragments");  // Cached per-service JSON for /api/services
+PsramAllocator* const MEMORY_POOLS[] = {
+  &apiMemory, &configMemory, &historyMemory, &eventMemory, &streamMemory, &notifyMemory, &pageMemory,
+  &fragmentMemory
+};
+const int MEMORY_POOL_COUNT = sizeof(MEMORY_POOLS) / sizeof(MEMORY_POOLS[0]);
+
+typedef std::vector<uint8_t, PsramStdAllocator<uint8_t> > PsramBuffer;
+
+// Pre-serialized JSON for GET /api/services, one entry per snapshot slot. Each
+// service object is assembled from two cached fragments (object members without
+// the braces) plus the time-derived fields printed per request:
+//   config  - id, name, target and thresholds; rebuilt when configVersion moves
+//   runtime - counters, state, telemetry, enabled/pause; rebuilt when changeVersion moves
+// Versions are unique across services, so a slot that now holds a different
+// service never matches a stale fragment. Only the /api/services handler touches
+// the cache, and it always runs on the web server task.
+struct ServiceJsonFragment {
+  ServiceJsonFragment() : version(0), json(PsramStdAllocator<uint8_t>(fragmentMemory)) {}
+  uint32_t version;  // 0 = not built yet
+  PsramBuffer json;  // Serialized object including its braces
+};
+
+struct ServiceJsonCacheEntry {
+  ServiceJsonFragment config;
+  ServiceJsonFragment runtime;
+};
+
+ServiceJsonCacheEntry* serviceJsonCache = nullptr;  // MAX_SERVICES entries, see allocateServiceStorage()
+uint32_t serviceJsonCacheHits = 0;    // Fragments reused as-is
+uint32_t serviceJsonCacheMisses = 0;  // Fragments (re)serialized
+
+// Request arenas: API handlers build their JsonDocuments and serialized body in a
+// RequestArena over slabs borrowed from requestSlabs, so steady polling reuses the
+// same fixed block instead of fragmenting the heap (see sendArenaJson()).
+#ifndef REQUEST_ARENA_SLAB_SIZE
+#define REQUEST_ARENA_SLAB_SIZE 4096
+#endif
+#ifndef REQUEST_ARENA_SLAB_COUNT
+#ifdef BOARD_HAS_PSRAM
+#define REQUEST_ARENA_SLAB_COUNT 16
+#else
+#define REQUEST_ARENA_SLAB_COUNT 4  // Power of two; reserved from internal RAM on these boards
+#endif
+#endif
+typedef SlabPool<REQUEST_ARENA_SLAB_SIZE, REQUEST_ARENA_SLAB_COUNT> RequestSlabPool;
+typedef RequestArena<RequestSlabPool> ApiArena;
+typedef std::shared_ptr<ApiArena> ApiArenaRef;
+RequestSlabPool requestSlabs;
+
+// Heap monitor: every HEAP_SAMPLE_INTERVAL_MS the aggregator task records free
+// heap, largest free block, min-ever free and fragmentation for internal RAM and
+// PSRAM into a ring served by /api/heap and /metrics. When the largest internal
+// block drops below what a TLS handshake needs (mbedTLS wants a ~16 KB record
+// buffer in one piece), heapTlsAlert turns on the LED/LCD warning locally, since
+// the alert can't be counted on to get out over HTTPS.
+const unsigned long HEAP_SAMPLE_INTERVAL_MS = 30000;
+const int HEAP_SAMPLE_COUNT = 120;                   // One hour of samples
+const uint32_t HEAP_TLS_MIN_BLOCK_BYTES = 22 * 1024;  // Handshake buffers plus headroom
+const uint32_t HEAP_TLS_CLEAR_MARGIN_BYTES = 4 * 1024;  // Hysteresis before clearing the alert
+
+struct HeapRegionSample {
+  uint32_t freeBytes;
+  uint32_t largestBlock;
+  uint32_t minFreeBytes;        // Lowest free since boot
+  uint8_t fragmentationPercent;  // 100 * (1 - largest / free)
+};
+
+struct HeapSample {
+  uint32_t uptimeSeconds;
+  HeapRegionSample internal;
+  HeapRegionSample psram;  // All zero on boards without PSRAM
+};
+
+HeapSample heapSamples[HEAP_SAMPLE_COUNT];
+uint32_t heapSamplesTaken = 0;  // Sample n lives in heapSamples[n % HEAP_SAMPLE_COUNT]
+portMUX_TYPE heapSamplesMux = portMUX_INITIALIZER_UNLOCKED;  // Ring is written by the aggregator, read by the web task
+volatile bool heapTlsAlert = false;
+uint32_t heapTlsAlertCount = 0;
+
+// Memory-pressure load shedding: every MEMORY_PRESSURE_CHECK_INTERVAL_MS the
+// aggregator compares the internal heap with the thresholds below and moves
+// between levels. Each level keeps the cuts of the levels under it:
+//   elevated  the LCD stops its periodic redraw; /api/histories serves 2-hour buckets
+//   high      recovery (UP) notifications wait in the retry queue instead of opening
+//             TLS connections; /admin is refused with 503; the static status page
+//             keeps serving its last render; histories coarsen to 4-hour buckets
+//   critical  check intervals are stretched 4x
+// A level is entered as soon as either threshold is crossed and left only once
+// both clear it by MEMORY_PRESSURE_RECOVER_MARGIN_BYTES. Transitions are logged
+// as system events.
+enum MemoryPressure {
+  PRESSURE_NORMAL,
+  PRESSURE_ELEVATED,
+  PRESSURE_HIGH,
+  PRESSURE_CRITICAL,
+  PRESSURE_LEVEL_COUNT
+};
+
+struct MemoryPressurePolicy {
+  const char* name;
+  uint32_t minLargestBlock;     // Level applies below this largest internal block (bytes)
+  uint32_t minFreeHeap;         // ... or below this much free internal heap (bytes)
+  bool pauseDisplayRefresh;
+  uint8_t minHistoryStep;       // Floor for /api/histories ?step= (hours per bucket)
+  bool deferRecoveryAlerts;
+  bool rejectAdminPages;
+  bool freezeStatusPage;
+  uint8_t checkIntervalScale;
+};
+
+const MemoryPressurePolicy MEMORY_PRESSURE_POLICIES[PRESSURE_LEVEL_COUNT] = {
+  {"normal",   0,                        0,         false, 1, false, false, false, 1},
+  {"elevated", 40 * 1024,                64 * 1024, true,  2, false, false, false, 1},
+  {"high",     HEAP_TLS_MIN_BLOCK_BYTES, 40 * 1024, true,  4, true,  true,  true,  1},
+  {"critical", 12 * 1024,                24 * 1024, true,  4, true,  true,  true,  4},
+};
+
+const unsigned long MEMORY_PRESSURE_CHECK_INTERVAL_MS = 5000;
+const uint32_t MEMORY_PRESSURE_RECOVER_MARGIN_BYTES = 8 * 1024;
+volatile MemoryPressure memoryPressure = PRESSURE_NORMAL;  // Written by the aggregator only
+uint32_t memoryPressureTransitions = 0;
+
+inline const MemoryPressurePolicy& currentPressurePolicy() {
+  return MEMORY_PRESSURE_POLICIES[memoryPressure];
+}
+
+// System events (memory pressure transitions): a small ring kept in RAM, served
+// by /api/system/events and pushed on /api/stream. Messages are fixed-size so
+// recording one never allocates, which matters most when the heap is short.
+const int SYSTEM_EVENT_COUNT = 32;
+const size_t SYSTEM_EVENT_MESSAGE_LENGTH = 96;
+
+struct SystemEvent {
+  unsigned long timestamp;  // time(), as for service events
+  uint32_t uptimeSeconds;
+  const char* kind;         // Static string, e.g. "memory_pressure"
+  char message[SYSTEM_EVENT_MESSAGE_LENGTH];
+};
+
+SystemEvent systemEvents[SYSTEM_EVENT_COUNT];
+uint32_t systemEventsRecorded = 0;  // Event n lives in systemEvents[n % SYSTEM_EVENT_COUNT]
+portMUX_TYPE systemEventsMux = portMUX_INITIALIZER_UNLOCKED;
+
 // Regex matching constants
 const int MAX_REGEX_PATTERN_LENGTH = 256;
 const char* REGEX_PREFIX = "regex:";
@@ -1270,9 +2111,21 @@ struct QueuedNotification {
 };
 
 const int MAX_QUEUED_NOTIFICATIONS = MAX_SERVICES;
-QueuedNotification notificationQueue[MAX_QUEUED_NOTIFICATIONS];
+QueuedNotification* notificationQueue = nullptr;  // Allocated with the service tables
 int queuedNotificationCount = 0;
 
+// Pending retries per channel for /metrics. Only the probe task touches
+// notificationQueue[]; it recounts after every pass and publishes the totals here,
+// so the web task never walks the queue while it is being shifted.
+struct NotificationQueueDepth {
+  int ntfy;
+  int discord;
+  int smtp;
+  int mesh;
+};
+NotificationQueueDepth notificationQueueDepth = {0, 0, 0, 0};
+portMUX_TYPE notificationQueueDepthMux = portMUX_INITIALIZER_UNLOCKED;
+
 // Retry interval for failed notifications (30 seconds for WiFi-based)
 const unsigned long NOTIFICATION_RETRY_INTERVAL = 30000;
 
@@ -1285,31 +2138,73 @@ void initWiFi();
 void initWebServer();
 void initFileSystem();
 bool ensureAuthenticated(AsyncWebServerRequest* request);
+void initSessions();
+String issueSessionToken();
+bool hasValidSession(AsyncWebServerRequest* request);
+String getSessionCookie(AsyncWebServerRequest* request);
+bool constantTimeEquals(const String& provided, const char* expected);
+#if FEATURE_ADMIN_PAGE
+String getLoginPage();
+#endif
+String makeEtag(char kind, uint32_t version, const String& detail = "");
+String makeContentEtag(char kind, uint32_t hash);
+bool sendNotModifiedIfMatch(AsyncWebServerRequest* request, const String& etag);
+ApiArenaRef newRequestArena();
+void sendArenaJson(AsyncWebServerRequest* request, const ApiArenaRef& arena, JsonDocument& doc,
+                   int code = 200, const String& etag = "");
+bool admitRequest(AsyncWebServerRequest* request, RequestClass requestClass);
+bool admitBody(AsyncWebServerRequest* request, RequestClass requestClass, size_t index);
+bool lockServicesForRequest(AsyncWebServerRequest* request);
+bool admitStreamConnect(AsyncWebServerRequest* request);
+void publishServiceCheck(const Service& service);
+void publishServiceStateChange(const Service& service, const String& reason);
+void publishServiceListChanged(const String& serviceId, const char* eventName);
+void publishHistoryChanged(const String& serviceId);
+void publishSystemEvent(const SystemEvent& event);
 void loadServices();
 void saveServices();
 String generateServiceId();
 String generatePushToken();
 void checkServices();
-void sendOfflineNotification(const Service& service);
-void sendOnlineNotification(const Service& service);
+void sendOfflineNotification(const Service& service, const String& groupSummary = "");
+void sendOnlineNotification(const Service& service, const String& groupSummary = "");
 void sendSmtpNotification(const String& title, const String& message);
-bool checkHttpGet(Service& service);
-bool checkPing(Service& service);
-bool checkSnmpGet(Service& service);
-bool checkPort(Service& service);
-bool checkPush(Service& service);
-bool checkUptime(Service& service);
-int matchesRegex(const String& text, const String& pattern);
+CheckPlanRef compileCheckPlan(const Service& service);
+bool checkHttpGet(const CheckPlan& plan, CheckOutcome& outcome);
+#if CHECK_TYPE_PING
+bool checkPing(const CheckPlan& plan, CheckOutcome& outcome);
+#endif
+#if CHECK_TYPE_SNMP
+bool checkSnmpGet(const CheckPlan& plan, CheckOutcome& outcome);
+#endif
+#if CHECK_TYPE_PORT
+bool checkPort(const CheckPlan& plan, CheckOutcome& outcome);
+#endif
+bool checkPush(const Service& service, CheckOutcome& outcome);
+#if CHECK_TYPE_UPTIME
+bool checkUptime(const CheckPlan& plan, CheckOutcome& outcome);
+#endif
+#if FEATURE_DASHBOARD_PAGE
 String getWebPage();
+#endif
+#if FEATURE_KIOSK_PAGE
 String getKioskPage();
+#endif
+#if FEATURE_ADMIN_PAGE
 String getAdminPage();
+#endif
 String getServiceTypeString(ServiceType type);
 String getSnmpCompareOpString(SnmpCompareOp op);
 SnmpCompareOp parseSnmpCompareOp(const String& opStr);
 bool compareSnmpValue(const String& actualValue, SnmpCompareOp op, const String& expectedValue);
+bool compareSnmpValue(const String& actualValue, SnmpCompareOp op, const char* expectedValue,
+                      bool expectedIsNumeric, float expectedNum);
+bool parseSnmpNumber(const char* text, float& value);
+#if FEATURE_SMTP
 String base64Encode(const String& input);
 bool readSmtpResponse(WiFiClient& client, int expectedCode);
 bool sendSmtpCommand(WiFiClient& client, const String& command, int expectedCode);
+#endif
 void sendBootNotification();
 
 // Historical data functions
@@ -1320,6 +2215,72 @@ void loadHistory();
 int getHistoryIndex(const String& serviceId);
 void finalizeCurrentHour(int historyIndex);
 void removeServiceHistory(const String& serviceId);
+void writeHistoryWindowJson(Print& out, int historyIndex, int hours, int step);
+void recordServiceTombstone(const String& serviceId);
+const char* getServiceDisplayState(const ServiceStatus& service, unsigned long now);
+String normalizeServiceTags(const String& tags);
+void parseServiceQuery(AsyncWebServerRequest* request, ServiceQuery& query);
+bool serviceMatchesQuery(const ServiceStatus& service, const ServiceQuery& query, unsigned long now);
+void sortServicesForQuery(const StatusSnapshot& snapshot, int* order, int count,
+                          const ServiceQuery& query, unsigned long now);
+void writeServiceJson(Print& out, int slot, const ServiceStatus& service, const ServiceQuery& query, unsigned long now);
+
+// Service group functions
+AggregateState getAggregateState(const Service& service, unsigned long now);
+String normalizeServiceGroup(const String& group);
+int findGroupSlot(const String& group);
+void rebuildGroupAggregates();
+int getGroupServiceTotal(const GroupStatus& group);
+const char* getGroupStatusString(const GroupStatus& group);
+void addGroupStatusJson(JsonObject obj, const GroupStatus& group);
+String describeServiceGroup(const Service& service);
+
+// Push ingestion functions
+uint32_t fnv1aHash(const char* data, size_t len);
+void rebuildServiceIndexes();
+int findPushServiceIndex(const String& token);
+int findServiceIndex(const String& serviceId);
+void allocateServiceStorage();
+void refreshServiceSchedule(int index);
+bool isScheduleDue(const ServiceSchedule& entry, unsigned long now);
+void processPushQueue();
+int findServiceIndexByHash(int slot, uint32_t idHash);
+void wakeAggregator();
+void startAggregatorTask();
+void runAggregatorPass();
+void aggregatorTask(void* parameter);
+void processCheckResults();
+void applyCheckResult(const CheckResultRecord& result);
+void queueAlert(int index, bool isUp);
+void processAlertQueue();
+void recordLatency(LatencyHistogram& histogram, uint32_t durationMs);
+
+// Task layout functions
+void runProbePass();
+void probeTask(void* parameter);
+void startProbeTask();
+void recordTaskPass(TaskSlot slot, unsigned long passStartMicros);
+
+// Heap monitor functions
+void readHeapRegion(uint32_t caps, HeapRegionSample& region);
+void sampleHeap();
+bool getHeapSample(uint32_t seq, HeapSample& sample);
+bool getLatestHeapSample(HeapSample& sample);
+void addHeapRegionJson(JsonObject obj, const HeapRegionSample& region);
+void handleHeapRequest(AsyncWebServerRequest* request);
+void updateMemoryPressure();
+void recordSystemEvent(const char* kind, const char* format, ...);
+void handleSystemEventsRequest(AsyncWebServerRequest* request);
+
+// Metrics functions
+String getCheckErrorString(CheckError code);
+void handleMetricsRequest(AsyncWebServerRequest *request);
+void resetServiceTelemetry(Service& service);
+
+// Static status page functions
+void renderStaticStatusPage(Print& out);
+void refreshStaticStatusPage();
+void handleStaticStatusRequest(AsyncWebServerRequest *request);
 
 // Event log functions
 void recordServiceEvent(const String& serviceId, bool isUp, const String& reason = "");
@@ -1341,14 +2302,99 @@ void queueNotification(const String& serviceId, const String& title, const Strin
                        bool smtpFailed, bool meshFailed);
 void processNotificationQueue();
 void processMeshCoreQueue();
+void publishNotificationQueueDepth();
 int findQueuedNotification(const String& serviceId);
 void removeQueuedNotification(int index);
 
+// Check type registry: one descriptor per type (see check_type_registry.hpp).
+// Adding a type means a ServiceType value, a descriptor and its probe; parsing,
+// naming, dispatch, import and /api/check-types all go through CheckTypes.
+struct HttpGetCheck {
+  static int id() { return TYPE_HTTP_GET; }
+  static const char* name() { return "http_get"; }
+  static unsigned flags() { return CHECK_NEEDS_HOST | CHECK_USES_PORT | CHECK_HAS_LATENCY; }
+  static const char* fields() { return "url,path,expectedResponse"; }
+  static bool probe(const CheckPlan& plan, CheckOutcome& outcome) { return checkHttpGet(plan, outcome); }
+};
+
+#if CHECK_TYPE_PING
+struct PingCheck {
+  static int id() { return TYPE_PING; }
+  static const char* name() { return "ping"; }
+  static unsigned flags() { return CHECK_NEEDS_HOST | CHECK_HAS_LATENCY; }
+  static const char* fields() { return ""; }
+  static bool probe(const CheckPlan& plan, CheckOutcome& outcome) { return checkPing(plan, outcome); }
+};
+#endif
+
+#if CHECK_TYPE_SNMP
+struct SnmpGetCheck {
+  static int id() { return TYPE_SNMP_GET; }
+  static const char* name() { return "snmp_get"; }
+  static unsigned flags() { return CHECK_NEEDS_HOST | CHECK_USES_PORT | CHECK_HAS_LATENCY; }
+  static const char* fields() { return "snmpOid,snmpCommunity,snmpCompareOp,snmpExpectedValue"; }
+  static bool probe(const CheckPlan& plan, CheckOutcome& outcome) { return checkSnmpGet(plan, outcome); }
+};
+#endif
+
+#if CHECK_TYPE_PORT
+struct PortCheck {
+  static int id() { return TYPE_PORT; }
+  static const char* name() { return "port"; }
+  static unsigned flags() { return CHECK_NEEDS_HOST | CHECK_USES_PORT | CHECK_HAS_LATENCY; }
+  static const char* fields() { return ""; }
+  static bool probe(const CheckPlan& plan, CheckOutcome& outcome) { return checkPort(plan, outcome); }
+};
+#endif
+
+// Judged by checkPush() from the live push state under servicesMutex, so the
+// probe is never dispatched
+struct PushCheck {
+  static int id() { return TYPE_PUSH; }
+  static const char* name() { return "push"; }
+  static unsigned flags() { return CHECK_PASSIVE; }
+  static const char* fields() { return "pushToken"; }
+  static bool probe(const CheckPlan&, CheckOutcome&) { return false; }
+};
+
+#if CHECK_TYPE_UPTIME
+struct UptimeCheck {
+  static int id() { return TYPE_UPTIME; }
+  static const char* name() { return "uptime"; }
+  static unsigned flags() { return 0; }
+  static const char* fields() { return "uptimeThreshold,uptimeCompareOp"; }
+  static bool probe(const CheckPlan& plan, CheckOutcome& outcome) { return checkUptime(plan, outcome); }
+};
+#endif
+
+typedef CheckTypeRegistry<
+  HttpGetCheck
+#if CHECK_TYPE_PING
+  , PingCheck
+#endif
+#if CHECK_TYPE_SNMP
+  , SnmpGetCheck
+#endif
+#if CHECK_TYPE_PORT
+  , PortCheck
+#endif
+  , PushCheck
+#if CHECK_TYPE_UPTIME
+  , UptimeCheck
+#endif
+> CheckTypes;
+
 void setup() {
   Serial.begin(115200);
   
   // Initialize services mutex
   servicesMutex = xSemaphoreCreateMutex();
+  allocateServiceStorage();
+  if (!requestSlabs.begin()) {
+    Serial.println("WARNING: request arena slabs unavailable; API responses use the heap");
+  }
+  statusBootEpoch = esp_random();
+  initSessions();
 
   // Simple delay for serial initialization - matches working ESP32-4848S040 implementation
   // from ESP32-Uptime-Monitoring-Touch. The previous complex !Serial wait loop was causing
@@ -1369,8 +2415,19 @@ void setup() {
   // Initialize WiFi
   initWiFi();
 
-  // Load saved services
+  // Load saved services, reporting the dynamic heap each one costs on top of its
+  // fixed slots (Strings and config blocks, across services[] and both snapshots)
+  size_t heapBeforeServices = ESP.getFreeHeap();
   loadServices();
+  if (serviceCount > 0) {
+    size_t configBytes = 0;
+    for (int i = 0; i < serviceCount; i++) {
+      configBytes += services[i].config.bytes();
+    }
+    long heapUsed = (long)heapBeforeServices - (long)ESP.getFreeHeap();
+    Serial.printf("Service heap: %ld bytes per service, %u of it in shared config blocks\n",
+                  heapUsed / serviceCount, (unsigned)(configBytes / serviceCount));
+  }
 
   // Load historical data
   loadHistory();
@@ -1378,6 +2435,9 @@ void setup() {
   // Load event logs
   loadEventLogs();
 
+  // Start applying check results and pushes in the background
+  startAggregatorTask();
+
   // Initialize web server
   initWebServer();
 
@@ -1405,47 +2465,21 @@ void setup() {
   initDisplay();
 #endif
 
+  // Hand checks and notifications to the probe task on the network core
+  startProbeTask();
+
   Serial.println("System ready!");
   Serial.print("Access web interface at: http://");
   Serial.println(WiFi.localIP());
 }
 
 void loop() {
-  static unsigned long lastCheckTime = 0;
-  static bool hasPerformedChecks = false;  // Track if any check has been performed
-  unsigned long currentTime = millis();
-
-#if DEBUG_LORA_FORCE_SEND_INTERVAL_MS > 0
-  static unsigned long lastLoRaDebugSend = 0;
-  static unsigned long nextDebugSendTime = DEBUG_LORA_FORCE_SEND_INTERVAL_MS;
-  static uint32_t debugMsgCounter = 0;
-  
-  // Add ±5 second jitter to avoid predictable collision patterns
-  if (currentTime >= nextDebugSendTime) {
-    lastLoRaDebugSend = currentTime;
-    debugMsgCounter++;
-    
-    // Calculate next send time with random jitter: base interval ± 5000ms
-    int32_t jitter = (esp_random() % 10001) - 5000;  // -5000 to +5000 ms
-    nextDebugSendTime = currentTime + DEBUG_LORA_FORCE_SEND_INTERVAL_MS + jitter;
-    Serial.printf("[LoRa] Next debug send in %lu ms (jitter: %ld ms)\n", 
-                  nextDebugSendTime - currentTime, jitter);
-    
-    // Create unique message with timestamp and counter
-    time_t now = time(nullptr);
-    struct tm* timeinfo = localtime(&now);
-    char timeStr[32];
-    strftime(timeStr, sizeof(timeStr), "%H:%M:%S", timeinfo);
-    
-    String debugMsg = String("Test #") + String(debugMsgCounter) + 
-                      String(" @") + String(timeStr);
-    sendLoRaChannelMessage("ESP32", debugMsg);
-  }
-#endif
+  unsigned long loopStartMicros = micros();
 
 #ifdef HAS_LCD
   // Re-scan I2C periodically if touch is not ready (helps debug startup issues)
   static unsigned long lastI2CScan = 0;
+  unsigned long currentTime = millis();
   if (!touchReady && (currentTime - lastI2CScan > 5000)) {
     lastI2CScan = currentTime;
     Serial.println("Touch not ready, re-scanning I2C...");
@@ -1466,15 +2500,114 @@ void loop() {
   // Update LED animation (call frequently for smooth pulsing)
   updateLed();
 
-#ifdef HAS_LORA_RADIO
-  // Poll LoRa receiver so incoming MeshCore packets are processed/logged
-  if (meshTransport != nullptr) {
-    meshTransport->processReceive();
+  // Checks and notifications run on the probe task; do them here only if it
+  // couldn't be started
+  if (probeTaskHandle == nullptr) {
+    runProbePass();
+    publishNotificationQueueDepth();
+  }
+
+  // While a BLE notification has WiFi switched off, keep the LED as it was
+  if (!monitoringPaused) {
+    // Update LED status based on WiFi, heap and service state
+    // Priority: No WiFi > MeshCore > Low memory > Service status
+    if (WiFi.status() != WL_CONNECTED) {
+      setLedStatus(LED_STATUS_NO_WIFI);
+    } else if (heapTlsAlert) {
+      // Alerts may silently stop going out, which matters more than any one service
+      setLedStatus(LED_STATUS_LOW_MEMORY);
+    } else if (!hasPerformedChecks && serviceCount > 0) {
+      // Still booting - haven't done any checks yet
+      setLedStatus(LED_STATUS_BOOTING);
+    } else if (serviceCount == 0) {
+      // No services configured - show green (nothing to monitor)
+      setLedStatus(LED_STATUS_ALL_UP);
+    } else {
+      // Check if any enabled service is down (either active or paused) from the
+      // aggregate counts rather than scanning every service each pass
+      StatusSnapshotReader snapshot;
+      const GroupStatus& totals = snapshot->groups.totals;
+      // Priority: Active down (red) > Paused down (orange) > All up (green)
+      if (totals.counts[AGG_DOWN] > 0) {
+        setLedStatus(LED_STATUS_ANY_DOWN);
+      } else if (totals.counts[AGG_PAUSED_DOWN] > 0) {
+        setLedStatus(LED_STATUS_PAUSED_DOWN);
+      } else {
+        setLedStatus(LED_STATUS_ALL_UP);
+      }
+    }
+  }
+
+  // Pushes and check results are applied by the aggregator task; drain them here
+  // only if it couldn't be started
+  if (aggregatorTaskHandle == nullptr) {
+    runAggregatorPass();
+  }
+
+  // Re-render the no-JavaScript status page if anything it shows has changed
+  refreshStaticStatusPage();
+
+#if FEATURE_OTA
+  // Handle OTA update events
+  ElegantOTA.loop();
+#endif
+
+#ifdef HAS_LCD
+  // Handle LCD display updates and touch input
+  handleDisplayLoop();
+#endif
+
+  recordTaskPass(TASK_LOOP, loopStartMicros);
+  delay(10);
+}
+
+// ---- Probe Task ----
+
+// One pass of the probe task: radio I/O, service checks and everything that sends
+// notifications. Alerts, the retry queue and MeshCore/BLE all stay on this one
+// task, so notificationQueue[] has a single owner and a BLE send (which switches
+// WiFi off) never overlaps a check.
+void runProbePass() {
+  static unsigned long lastCheckTime = 0;
+  unsigned long currentTime = millis();
+
+#if DEBUG_LORA_FORCE_SEND_INTERVAL_MS > 0
+  static unsigned long lastLoRaDebugSend = 0;
+  static unsigned long nextDebugSendTime = DEBUG_LORA_FORCE_SEND_INTERVAL_MS;
+  static uint32_t debugMsgCounter = 0;
+  
+  // Add ±5 second jitter to avoid predictable collision patterns
+  if (currentTime >= nextDebugSendTime) {
+    lastLoRaDebugSend = currentTime;
+    debugMsgCounter++;
+    
+    // Calculate next send time with random jitter: base interval ± 5000ms
+    int32_t jitter = (esp_random() % 10001) - 5000;  // -5000 to +5000 ms
+    nextDebugSendTime = currentTime + DEBUG_LORA_FORCE_SEND_INTERVAL_MS + jitter;
+    Serial.printf("[LoRa] Next debug send in %lu ms (jitter: %ld ms)\n", 
+                  nextDebugSendTime - currentTime, jitter);
+    
+    // Create unique message with timestamp and counter
+    time_t now = time(nullptr);
+    struct tm* timeinfo = localtime(&now);
+    char timeStr[32];
+    strftime(timeStr, sizeof(timeStr), "%H:%M:%S", timeinfo);
+    
+    String debugMsg = String("Test #") + String(debugMsgCounter) + 
+                      String(" @") + String(timeStr);
+    sendLoRaChannelMessage("ESP32", debugMsg);
+  }
+#endif
+
+#ifdef HAS_LORA_RADIO
+  // Poll LoRa receiver so incoming MeshCore packets are processed/logged
+  if (meshTransport != nullptr) {
+    meshTransport->processReceive();
   }
 #endif
 
   // Process pending MeshCore notifications from HTTP handlers
-  // This runs in the main loop to avoid blocking the async web server
+  // This runs in the probe task to avoid blocking the async web server
   // and prevents task watchdog timeouts from WiFi/BLE switching during HTTP responses
   if (pendingMeshNotification && !bleOperationInProgress) {
     // Copy values and clear flag atomically to prevent race conditions with HTTP handler.
@@ -1495,48 +2628,11 @@ void loop() {
 
   // Skip service checks if monitoring is paused (e.g., during BLE operations)
   if (monitoringPaused) {
-    delay(10);
     return;
   }
 
-  // Update LED status based on WiFi and service state
-  // Priority: No WiFi > MeshCore > Service status
-  if (WiFi.status() != WL_CONNECTED) {
-    setLedStatus(LED_STATUS_NO_WIFI);
-  } else if (!hasPerformedChecks && serviceCount > 0) {
-    // Still booting - haven't done any checks yet
-    setLedStatus(LED_STATUS_BOOTING);
-  } else if (serviceCount == 0) {
-    // No services configured - show green (nothing to monitor)
-    setLedStatus(LED_STATUS_ALL_UP);
-  } else {
-    // Check if any enabled service is down (either active or paused)
-    bool anyActiveDown = false;
-    bool anyPausedDown = false;
-    unsigned long currentTimeMs = millis();
-    for (int i = 0; i < serviceCount; i++) {
-      if (services[i].enabled && !services[i].isUp && services[i].lastCheck > 0) {
-        // Check if service is paused (rollover-safe)
-        if (getPauseRemainingMs(services[i].pauseUntil, currentTimeMs) > 0) {
-          anyPausedDown = true;
-        } else {
-          anyActiveDown = true;
-          break;  // Active down takes priority, no need to check further
-        }
-      }
-    }
-    // Priority: Active down (red) > Paused down (orange) > All up (green)
-    if (anyActiveDown) {
-      setLedStatus(LED_STATUS_ANY_DOWN);
-    } else if (anyPausedDown) {
-      setLedStatus(LED_STATUS_PAUSED_DOWN);
-    } else {
-      setLedStatus(LED_STATUS_ALL_UP);
-    }
-  }
-
   // Check services every 5 seconds
-  if (currentTime - lastCheckTime >= 5000) {
+  if (currentTime - lastCheckTime >= CHECK_INTERVAL_MS) {
     checkServices();
     lastCheckTime = currentTime;
     if (serviceCount > 0) {
@@ -1544,28 +2640,56 @@ void loop() {
     }
   }
 
-  // Save history periodically (every 5 minutes)
-  static unsigned long lastHistorySave = 0;
-  if (currentTime - lastHistorySave >= 300000) {  // 5 minutes
-    saveHistory();
-    lastHistorySave = currentTime;
-  }
+  // Send up/down notifications decided by the aggregator
+  processAlertQueue();
 
   // Process notification queue for failed notifications (WiFi-based)
   processNotificationQueue();
   
   // Process MeshCore queue separately (batched, 10 minute interval)
   processMeshCoreQueue();
-  
-  // Handle OTA update events
-  ElegantOTA.loop();
+}
 
-#ifdef HAS_LCD
-  // Handle LCD display updates and touch input
-  handleDisplayLoop();
-#endif
+void probeTask(void* parameter) {
+  for (;;) {
+    unsigned long passStartMicros = micros();
+    runProbePass();
+    publishNotificationQueueDepth();
+    recordTaskPass(TASK_PROBE, passStartMicros);
+    vTaskDelay(pdMS_TO_TICKS(PROBE_TASK_IDLE_MS));
+  }
+}
 
-  delay(10);
+// Called at the end of setup(). If the task can't be created, loop() runs the
+// probe passes itself, as it did before the work was split across cores.
+void startProbeTask() {
+  if (xTaskCreatePinnedToCore(probeTask, "probe", PROBE_TASK_STACK_SIZE, nullptr,
+                              PROBE_TASK_PRIORITY, &probeTaskHandle, PROBE_TASK_CORE) != pdPASS) {
+    probeTaskHandle = nullptr;
+    Serial.println("ERROR: Failed to start probe task; running checks from loop()");
+  }
+}
+
+// Accumulate one pass of a task's run time for /metrics
+void recordTaskPass(TaskSlot slot, unsigned long passStartMicros) {
+  uint32_t elapsed = micros() - passStartMicros;
+  TaskStats& stats = taskStats[slot];
+  bool sampleStack = stats.passes % TASK_STACK_SAMPLE_PASSES == 0;  // Only this task writes passes
+  uint32_t stackFree = sampleStack ? uxTaskGetStackHighWaterMark(nullptr) : 0;  // Bytes on ESP-IDF
+
+  // Short critical section so a scrape never sees a half-written 64-bit counter
+  portENTER_CRITICAL(&taskStatsMux);
+  stats.core = (int8_t)xPortGetCoreID();
+  stats.busyMicros += elapsed;
+  stats.lastMicros = elapsed;
+  if (elapsed > stats.maxMicros) {
+    stats.maxMicros = elapsed;
+  }
+  if (sampleStack) {
+    stats.stackFreeBytes = stackFree;
+  }
+  stats.passes++;
+  portEXIT_CRITICAL(&taskStatsMux);
 }
 
 void initWiFi() {
@@ -1714,14 +2838,407 @@ bool ensureAuthenticated(AsyncWebServerRequest* request) {
     return true;
   }
 
-  if (request->authenticate(WEB_AUTH_USERNAME, WEB_AUTH_PASSWORD)) {
+  // Session cookie first: one HMAC, no credentials on the wire
+  if (hasValidSession(request)) {
+    return true;
+  }
+
+  // Basic Auth keeps working for scripts and curl
+  if (request->hasHeader("Authorization") && request->authenticate(WEB_AUTH_USERNAME, WEB_AUTH_PASSWORD)) {
     return true;
   }
 
+  // A browser holding a stale session is sent back to the login page by the
+  // admin UI; don't trigger the Basic Auth prompt for it
+  if (getSessionCookie(request).length() > 0) {
+    request->send(401, "application/json", "{\"error\":\"Session expired\"}");
+    return false;
+  }
+
   request->requestAuthentication();
   return false;
 }
 
+// ---- Sessions ----
+
+void initSessions() {
+  uint8_t key[32];
+  esp_fill_random(key, sizeof(key));
+  mbedtls_md_init(&sessionHmac);
+  mbedtls_md_setup(&sessionHmac, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 1);
+  mbedtls_md_hmac_starts(&sessionHmac, key, sizeof(key));
+  memset(key, 0, sizeof(key));
+}
+
+// Seconds since boot; 64-bit timer so it doesn't wrap like millis()
+static uint32_t sessionClockSeconds() {
+  return (uint32_t)(esp_timer_get_time() / 1000000LL);
+}
+
+// Hex HMAC over "<generation>:<payload>" using the cached keyed context
+static String computeSessionMac(const String& payload) {
+  String input = String(sessionGeneration) + ":" + payload;
+  uint8_t mac[32];
+  mbedtls_md_hmac_reset(&sessionHmac);
+  mbedtls_md_hmac_update(&sessionHmac, (const unsigned char*)input.c_str(), input.length());
+  mbedtls_md_hmac_finish(&sessionHmac, mac);
+
+  char hex[sizeof(mac) * 2 + 1];
+  for (size_t i = 0; i < sizeof(mac); i++) {
+    snprintf(hex + i * 2, 3, "%02x", mac[i]);
+  }
+  return String(hex);
+}
+
+// Compare without an early exit so timing doesn't reveal the matching prefix
+bool constantTimeEquals(const String& provided, const char* expected) {
+  size_t expectedLen = strlen(expected);
+  uint8_t diff = provided.length() != expectedLen;
+  for (size_t i = 0; i < expectedLen; i++) {
+    char c = i < provided.length() ? provided[i] : 0;
+    diff |= (uint8_t)(c ^ expected[i]);
+  }
+  return diff == 0;
+}
+
+String issueSessionToken() {
+  char payload[24];
+  snprintf(payload, sizeof(payload), "%lu.%08lx",
+           (unsigned long)(sessionClockSeconds() + SESSION_TTL_SECONDS), (unsigned long)esp_random());
+  return String(payload) + "." + computeSessionMac(payload);
+}
+
+// Value of the session cookie, or "" if the request doesn't carry one
+String getSessionCookie(AsyncWebServerRequest* request) {
+  if (!request->hasHeader("Cookie")) {
+    return "";
+  }
+  String cookies = request->getHeader("Cookie")->value();
+  String prefix = String(SESSION_COOKIE_NAME) + "=";
+  int start = 0;
+  while (start < (int)cookies.length()) {
+    int end = cookies.indexOf(';', start);
+    if (end < 0) end = cookies.length();
+    String cookie = cookies.substring(start, end);
+    cookie.trim();
+    if (cookie.startsWith(prefix)) {
+      return cookie.substring(prefix.length());
+    }
+    start = end + 1;
+  }
+  return "";
+}
+
+bool hasValidSession(AsyncWebServerRequest* request) {
+  String token = getSessionCookie(request);
+  int macSeparator = token.lastIndexOf('.');
+  if (macSeparator <= 0) {
+    return false;
+  }
+
+  String payload = token.substring(0, macSeparator);
+  String expected = computeSessionMac(payload);
+  if (!constantTimeEquals(token.substring(macSeparator + 1), expected.c_str())) {
+    return false;
+  }
+
+  // Signature is good, so the expiry field is ours
+  uint32_t expiry = strtoul(payload.c_str(), nullptr, 10);
+  return (int32_t)(expiry - sessionClockSeconds()) > 0;
+}
+
+// Build a strong ETag from a change-tracking version, e.g. "s1f3a9c07.42". The
+// versions restart at 1 every boot, so the tag carries statusBootEpoch: a copy
+// cached before a reboot never matches once the new boot reaches the same number.
+// detail adds anything else the body depends on, e.g. "-3-2".
+String makeEtag(char kind, uint32_t version, const String& detail) {
+  char etag[32];
+  snprintf(etag, sizeof(etag), "\"%c%08lx.%lu", kind, (unsigned long)statusBootEpoch, (unsigned long)version);
+  return String(etag) + detail + "\"";
+}
+
+// Build a strong ETag from a hash of the body itself; stays valid across reboots
+String makeContentEtag(char kind, uint32_t hash) {
+  char etag[16];
+  snprintf(etag, sizeof(etag), "\"%c%lu\"", kind, (unsigned long)hash);
+  return String(etag);
+}
+
+// Answer 304 Not Modified when the client's If-None-Match already holds etag.
+// Returns true if the response was sent and the handler should stop.
+bool sendNotModifiedIfMatch(AsyncWebServerRequest* request, const String& etag) {
+  if (!request->hasHeader("If-None-Match")) {
+    return false;
+  }
+  // Browsers may send a list of tags (or weak W/ variants); a substring match covers both
+  if (request->getHeader("If-None-Match")->value().indexOf(etag) < 0) {
+    return false;
+  }
+
+  AsyncWebServerResponse* response = request->beginResponse(304);
+  response->addHeader("ETag", etag);
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+  return true;
+}
+
+// Fresh arena for one API request; what doesn't fit its slabs goes to apiMemory
+ApiArenaRef newRequestArena() {
+  return std::make_shared<ApiArena>(requestSlabs, apiMemory);
+}
+
+// Serialize doc into the request's arena and send it. The response filler keeps
+// the arena alive until the body has been written out; freeing the response then
+// returns every slab to the pool at once. A non-empty etag is sent with "no-cache"
+// so the next poll can be answered with a 304 (browsers revalidate on every fetch()
+// instead of serving stale data).
+void sendArenaJson(AsyncWebServerRequest* request, const ApiArenaRef& arena, JsonDocument& doc,
+                   int code, const String& etag) {
+  size_t len = measureJson(doc);
+  char* data = static_cast<char*>(arena->allocate(len + 1));
+  AsyncWebServerResponse* response;
+  if (data != nullptr) {
+    serializeJson(doc, data, len + 1);
+    // The body may have overflowed to the heap, so hand it back through the arena
+    ApiArenaRef owner = arena;
+    std::shared_ptr<char> body(data, [owner](char* p) { owner->deallocate(p); });
+    response = request->beginResponse("application/json", len,
+      [body, len](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+        size_t remaining = len - index;
+        size_t chunk = remaining < maxLen ? remaining : maxLen;
+        memcpy(buffer, body.get() + index, chunk);
+        return chunk;
+      });
+    response->setCode(code);
+  } else {
+    String json;
+    serializeJson(doc, json);
+    response = request->beginResponse(code, "application/json", json);
+  }
+  if (etag.length() > 0) {
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+  }
+  request->send(response);
+}
+
+// ---- Request Admission ----
+
+// Take one token from the client's bucket in table; false if the client is over its rate
+static bool takeClientToken(ClientBucket* table, float capacity, float refillPerSec,
+                            uint32_t ip, unsigned long now) {
+  int slot = -1;
+  int oldest = 0;
+  for (int i = 0; i < CLIENT_BUCKET_COUNT; i++) {
+    if (table[i].ip == ip) {
+      slot = i;
+      break;
+    }
+    if (table[i].ip == 0 || table[i].lastRefill < table[oldest].lastRefill) {
+      oldest = i;
+    }
+  }
+
+  if (slot == -1) {
+    // New client: recycle the least recently seen entry
+    slot = oldest;
+    table[slot].ip = ip;
+    table[slot].tokens = capacity;
+    table[slot].lastRefill = now;
+  }
+
+  ClientBucket& bucket = table[slot];
+  bucket.tokens += (now - bucket.lastRefill) * refillPerSec / 1000.0f;
+  if (bucket.tokens > capacity) {
+    bucket.tokens = capacity;
+  }
+  bucket.lastRefill = now;
+
+  if (bucket.tokens < 1.0f) {
+    return false;
+  }
+  bucket.tokens -= 1.0f;
+  return true;
+}
+
+static void rejectRequest(AsyncWebServerRequest* request, RequestClass requestClass, AdmissionReject reason) {
+  admissionRejections[requestClass][reason]++;
+  int code = reason == REJECT_RATE ? 429 : 503;
+  const char* body = reason == REJECT_RATE ? "{\"error\":\"Too many requests\"}" : "{\"error\":\"Server busy\"}";
+  AsyncWebServerResponse* response = request->beginResponse(code, "application/json", body);
+  response->addHeader("Retry-After", String(reason == REJECT_CONCURRENCY ? 1 : ADMISSION_RETRY_AFTER_SECONDS));
+  request->send(response);
+}
+
+// Client bucket and heap checks shared by admitRequest() and admitStreamConnect();
+// REJECT_REASON_COUNT if the request may go on to the concurrency check
+static AdmissionReject checkRateAndHeap(AsyncWebServerRequest* request, RequestClass requestClass) {
+  const AdmissionPolicy& policy = ADMISSION_POLICIES[requestClass];
+
+  AsyncClient* client = request->client();
+  uint32_t ip = client != nullptr ? (uint32_t)client->remoteIP() : 0;
+  bool login = requestClass == REQ_LOGIN;
+  if (ip != 0 && !takeClientToken(login ? loginBuckets : clientBuckets,
+                                  login ? LOGIN_BUCKET_CAPACITY : CLIENT_BUCKET_CAPACITY,
+                                  login ? LOGIN_BUCKET_REFILL_PER_SEC : CLIENT_BUCKET_REFILL_PER_SEC,
+                                  ip, millis())) {
+    return REJECT_RATE;
+  }
+
+  if (ESP.getFreeHeap() < policy.minFreeHeap || ESP.getMaxAllocHeap() < policy.minLargestBlock) {
+    return REJECT_HEAP;
+  }
+  return REJECT_REASON_COUNT;
+}
+
+// Admission gate for web handlers. Returns false (after sending 429/503) if the
+// request must not be served; otherwise the request holds a slot of its class
+// until the connection closes.
+bool admitRequest(AsyncWebServerRequest* request, RequestClass requestClass) {
+  const AdmissionPolicy& policy = ADMISSION_POLICIES[requestClass];
+
+  AdmissionReject reason = checkRateAndHeap(request, requestClass);
+  if (reason != REJECT_REASON_COUNT) {
+    rejectRequest(request, requestClass, reason);
+    return false;
+  }
+
+  if (policy.maxInFlight > 0) {
+    if (requestsInFlight[requestClass] >= policy.maxInFlight) {
+      rejectRequest(request, requestClass, REJECT_CONCURRENCY);
+      return false;
+    }
+    requestsInFlight[requestClass]++;
+    request->onDisconnect([requestClass]() {
+      requestsInFlight[requestClass]--;
+    });
+  }
+  return true;
+}
+
+// Admission for body handlers, which run once per received chunk. Only the first
+// chunk is admitted (one token per request); the verdict is kept in the request's
+// _tempObject, which the server frees with the request, so later chunks of a
+// rejected request are dropped instead of answered a second time.
+bool admitBody(AsyncWebServerRequest* request, RequestClass requestClass, size_t index) {
+  if (index == 0) {
+    bool admitted = admitRequest(request, requestClass);
+    uint8_t* verdict = static_cast<uint8_t*>(malloc(1));
+    if (verdict != nullptr) {
+      *verdict = admitted ? 1 : 0;
+      request->_tempObject = verdict;
+    }
+    return admitted;
+  }
+  return request->_tempObject != nullptr && *static_cast<uint8_t*>(request->_tempObject) != 0;
+}
+
+// authorizeConnect() gate for /api/stream. The library answers a refused connect
+// itself (403), so this only counts the rejection.
+bool admitStreamConnect(AsyncWebServerRequest* request) {
+  AdmissionReject reason = checkRateAndHeap(request, REQ_STREAM);
+  if (reason == REJECT_REASON_COUNT && statusEvents.count() >= ADMISSION_POLICIES[REQ_STREAM].maxInFlight) {
+    reason = REJECT_CONCURRENCY;
+  }
+  if (reason != REJECT_REASON_COUNT) {
+    admissionRejections[REQ_STREAM][reason]++;
+    return false;
+  }
+  return true;
+}
+
+// Take servicesMutex for a web handler with a bounded wait; false (after answering
+// 503) if the aggregator or another task held it for longer than WEB_LOCK_TIMEOUT
+bool lockServicesForRequest(AsyncWebServerRequest* request) {
+  if (xSemaphoreTake(servicesMutex, WEB_LOCK_TIMEOUT)) {
+    return true;
+  }
+  AsyncWebServerResponse* response = request->beginResponse(503, "application/json", "{\"error\":\"Server busy\"}");
+  response->addHeader("Retry-After", "1");
+  request->send(response);
+  return false;
+}
+
+// ---- Live Status Stream ----
+// Event types pushed on /api/stream (data is always a small JSON object):
+//   hello   - sent on (re)connect with the current statusVersion; clients resync once
+//   check   - runtime fields of one service after a check or push result
+//   state   - a service transitioned UP/DOWN (sent in addition to "check")
+//   service - a service was added, edited, paused or enabled; clients refetch the list
+//   removed - a service was deleted
+//   history - a service's hourly uptime buckets changed
+//   system  - a system event was recorded (e.g. a memory pressure level change)
+// Field names match /api/services so clients can merge "check" deltas in place.
+// The SSE event id is the statusVersion of the change.
+
+void publishServiceCheck(const Service& service) {
+  if (statusEvents.count() == 0) return;
+
+  unsigned long now = millis();
+  JsonDocument doc(&streamMemory);
+  doc["id"] = service.id;
+  doc["isUp"] = service.isUp;
+  doc["lastError"] = service.lastError;
+  doc["consecutivePasses"] = service.consecutivePasses;
+  doc["consecutiveFails"] = service.consecutiveFails;
+  doc["failedChecksSinceAlert"] = service.failedChecksSinceAlert;
+  doc["secondsSinceLastCheck"] = service.lastCheck > 0 ? (long)((now - service.lastCheck) / 1000) : -1L;
+  doc["enabled"] = service.enabled;
+  doc["pauseRemaining"] = getPauseRemainingMs(service.pauseUntil, now) / 1000;
+
+  String payload;
+  serializeJson(doc, payload);
+  statusEvents.send(payload.c_str(), "check", service.changeVersion);
+}
+
+void publishServiceStateChange(const Service& service, const String& reason) {
+  if (statusEvents.count() == 0) return;
+
+  JsonDocument doc(&streamMemory);
+  doc["id"] = service.id;
+  doc["isUp"] = service.isUp;
+  doc["reason"] = reason;
+
+  String payload;
+  serializeJson(doc, payload);
+  statusEvents.send(payload.c_str(), "state", service.changeVersion);
+}
+
+void publishServiceListChanged(const String& serviceId, const char* eventName) {
+  if (statusEvents.count() == 0) return;
+
+  JsonDocument doc(&streamMemory);
+  doc["id"] = serviceId;
+
+  String payload;
+  serializeJson(doc, payload);
+  statusEvents.send(payload.c_str(), eventName, statusVersion.load());
+}
+
+void publishHistoryChanged(const String& serviceId) {
+  if (statusEvents.count() == 0) return;
+
+  JsonDocument doc(&streamMemory);
+  doc["id"] = serviceId;
+
+  String payload;
+  serializeJson(doc, payload);
+  statusEvents.send(payload.c_str(), "history", historyVersion.load());
+}
+
+void publishSystemEvent(const SystemEvent& event) {
+  if (statusEvents.count() == 0) return;
+
+  JsonDocument doc(&streamMemory);
+  doc["timestamp"] = event.timestamp;
+  doc["kind"] = event.kind;
+  doc["message"] = event.message;
+
+  String payload;
+  serializeJson(doc, payload);
+  statusEvents.send(payload.c_str(), "system", statusVersion.load());
+}
+
 void initFileSystem() {
   littleFsReady = false;
 
@@ -1843,22 +3360,110 @@ void reconnectWiFi() {
 void initWebServer() {
 
   server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!admitRequest(request, REQ_PAGE)) {
+      return;
+    }
+#if FEATURE_DASHBOARD_PAGE
     request->send(200, "text/html", getWebPage());
+#else
+    request->redirect("/status");
+#endif
+  });
+
+  server.on("/status", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!admitRequest(request, REQ_PAGE)) {
+      return;
+    }
+    handleStaticStatusRequest(request);
   });
 
+#if FEATURE_KIOSK_PAGE
   server.on("/kiosk", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!admitRequest(request, REQ_PAGE)) {
+      return;
+    }
     request->send(200, "text/html", getKioskPage());
   });
+#endif
 
+#if FEATURE_ADMIN_PAGE
   server.on("/admin", HTTP_GET, [](AsyncWebServerRequest *request) {
+    // The status pages keep working; the admin UI can wait until the heap recovers
+    if (currentPressurePolicy().rejectAdminPages) {
+      rejectRequest(request, REQ_PAGE, REJECT_PRESSURE);
+      return;
+    }
+    if (!admitRequest(request, REQ_PAGE)) {
+      return;
+    }
+    bool authRequired = strlen(WEB_AUTH_USERNAME) > 0 && strlen(WEB_AUTH_PASSWORD) > 0;
+    if (!authRequired || hasValidSession(request)) {
+      request->send(200, "text/html", getAdminPage());
+      return;
+    }
+    if (request->hasHeader("Authorization") && request->authenticate(WEB_AUTH_USERNAME, WEB_AUTH_PASSWORD)) {
+      // Existing Basic Auth bookmark: upgrade it to a session
+      AsyncWebServerResponse *response = request->beginResponse(200, "text/html", getAdminPage());
+      response->addHeader("Set-Cookie", String(SESSION_COOKIE_NAME) + "=" + issueSessionToken() +
+                          "; Path=/; Max-Age=" + String(SESSION_TTL_SECONDS) + "; HttpOnly; SameSite=Strict");
+      request->send(response);
+      return;
+    }
+    request->send(200, "text/html", getLoginPage());
+  });
+#endif
+
+  // Exchange credentials for a session cookie
+  // POST /api/login {"username": "...", "password": "..."}
+  server.on("/api/login", HTTP_POST, [](AsyncWebServerRequest *request) {}, NULL,
+    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+      if (!admitBody(request, REQ_LOGIN, index)) {
+        return;
+      }
+
+      ApiArenaRef arena = newRequestArena();
+      JsonDocument doc(arena.get());
+      if (deserializeJson(doc, data, len)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+      }
+
+      String username = doc["username"] | "";
+      String password = doc["password"] | "";
+      // Evaluate both so a wrong username costs the same as a wrong password
+      bool userOk = constantTimeEquals(username, WEB_AUTH_USERNAME);
+      bool passOk = constantTimeEquals(password, WEB_AUTH_PASSWORD);
+      if (!userOk || !passOk) {
+        Serial.println("Admin login failed");
+        request->send(401, "application/json", "{\"error\":\"Invalid credentials\"}");
+        return;
+      }
+
+      AsyncWebServerResponse *response = request->beginResponse(200, "application/json",
+        "{\"success\":true,\"expiresIn\":" + String(SESSION_TTL_SECONDS) + "}");
+      response->addHeader("Set-Cookie", String(SESSION_COOKIE_NAME) + "=" + issueSessionToken() +
+                          "; Path=/; Max-Age=" + String(SESSION_TTL_SECONDS) + "; HttpOnly; SameSite=Strict");
+      request->send(response);
+    }
+  );
+
+  // End the session; bumping the generation invalidates every issued cookie
+  server.on("/api/logout", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (!ensureAuthenticated(request)) {
       return;
     }
-    request->send(200, "text/html", getAdminPage());
+    sessionGeneration++;
+    AsyncWebServerResponse *response = request->beginResponse(200, "application/json", "{\"success\":true}");
+    response->addHeader("Set-Cookie", String(SESSION_COOKIE_NAME) + "=; Path=/; Max-Age=0; HttpOnly; SameSite=Strict");
+    request->send(response);
   });
 
   server.on("/api/mesh/status", HTTP_GET, [](AsyncWebServerRequest *request) {
-    JsonDocument doc;
+    if (!admitRequest(request, REQ_API_READ)) {
+      return;
+    }
+    ApiArenaRef arena = newRequestArena();
+    JsonDocument doc(arena.get());
     doc["connected"] = isMeshDeviceConnected();
     doc["peerName"] = BLE_PEER_NAME;
     doc["deviceName"] = BLE_DEVICE_NAME;
@@ -1874,9 +3479,7 @@ void initWebServer() {
     doc["pendingNotification"] = (bool)pendingMeshNotification;
     doc["monitoringPaused"] = monitoringPaused;
 
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    sendArenaJson(request, arena, doc);
   });
 
   server.on("/api/mesh/send", HTTP_POST, [](AsyncWebServerRequest *request) {}, NULL,
@@ -1884,6 +3487,9 @@ void initWebServer() {
       if (!ensureAuthenticated(request)) {
         return;
       }
+      if (!admitBody(request, REQ_API_WRITE, index)) {
+        return;
+      }
 
       // Check if a BLE operation is already in progress or queued
       if (bleOperationInProgress || pendingMeshNotification) {
@@ -1891,7 +3497,8 @@ void initWebServer() {
         return;
       }
 
-      JsonDocument doc;
+      ApiArenaRef arena = newRequestArena();
+      JsonDocument doc(arena.get());
       if (deserializeJson(doc, data, len) != DeserializationError::Ok) {
         request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
         return;
@@ -1926,6 +3533,9 @@ void initWebServer() {
     if (!ensureAuthenticated(request)) {
       return;
     }
+    if (!admitRequest(request, REQ_API_WRITE)) {
+      return;
+    }
 
     // Check if any notification channels are configured
     if (!isNtfyConfigured() && !isDiscordConfigured() && !isSmtpConfigured() && !isMeshCoreConfigured()) {
@@ -1937,7 +3547,8 @@ void initWebServer() {
     String message = "This is a test notification from your ESP32 Uptime Monitor. All notification channels are working correctly.";
     String tags = "test,monitor";
     
-    JsonDocument doc;
+    ApiArenaRef arena = newRequestArena();
+    JsonDocument doc(arena.get());
     JsonArray results = doc["results"].to<JsonArray>();
     int successCount = 0;
     int totalCount = 0;
@@ -2005,64 +3616,89 @@ void initWebServer() {
     doc["successCount"] = successCount;
     doc["totalCount"] = totalCount;
     
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    sendArenaJson(request, arena, doc);
   });
 
   // get services
+  // GET /api/services                          - full list
+  // GET /api/services?since=<version>&epoch=<e> - only services changed after <version>,
+  //   plus IDs removed since then. Falls back to the full list (full:true) when the
+  //   epoch doesn't match this boot or the deletions have aged out of the tombstone ring.
   server.on("/api/services", HTTP_GET, [](AsyncWebServerRequest *request) {
-    JsonDocument doc;
-    JsonArray array = doc["services"].to<JsonArray>();
+    if (!admitRequest(request, REQ_API_READ)) {
+      return;
+    }
+    // The snapshot is consistent with its own version, so the ETag always
+    // describes exactly the body that is sent
+    StatusSnapshotReader snapshot;
+    uint32_t version = snapshot->version;
+    String etag = makeEtag('s', version);
+    if (sendNotModifiedIfMatch(request, etag)) {
+      return;
+    }
+
+    uint32_t since = 0;
+    if (request->hasParam("since") && request->hasParam("epoch")) {
+      uint32_t epoch = strtoul(request->getParam("epoch")->value().c_str(), nullptr, 10);
+      since = strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+      if (epoch != statusBootEpoch || since > version || since < serviceTombstoneFloor) {
+        since = 0;
+      }
+    }
+
+    ServiceQuery query;
+    parseServiceQuery(request, query);
+    // A filtered delta can't tell clients which services stopped matching, so
+    // filtered requests always get the full (filtered) list
+    if (query.filtered) {
+      since = 0;
+    }
+    bool full = (since == 0);
 
     unsigned long currentTime = millis();
 
-    for (int i = 0; i < serviceCount; i++) {
-      if (services[i].lastCheck > 0) {
-        services[i].secondsSinceLastCheck = (currentTime - services[i].lastCheck) / 1000;
-      } else {
-        services[i].secondsSinceLastCheck = -1; // Never checked
+    std::vector<int> order(snapshot->count);
+    int matched = 0;
+    for (int i = 0; i < snapshot->count; i++) {
+      const ServiceStatus& service = snapshot->services[i];
+      if (!full && service.changeVersion <= since) {
+        continue;
       }
+      if (!serviceMatchesQuery(service, query, currentTime)) {
+        continue;
+      }
+      order[matched++] = i;
+    }
+    sortServicesForQuery(*snapshot, order.data(), matched, query, currentTime);
+
+    // Written one service at a time instead of building a document for the whole list
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    response->printf("{\"version\":%lu,\"epoch\":%lu,\"full\":%s,\"services\":[",
+                     (unsigned long)version, (unsigned long)statusBootEpoch, full ? "true" : "false");
+    for (int i = 0; i < matched; i++) {
+      if (i > 0) {
+        response->print(",");
+      }
+      writeServiceJson(*response, order[i], snapshot->services[order[i]], query, currentTime);
+    }
+    response->print("]");
 
-      JsonObject obj = array.add<JsonObject>();
-      obj["id"] = services[i].id;
-      obj["name"] = services[i].name;
-      obj["type"] = getServiceTypeString(services[i].type);
-      obj["host"] = services[i].host;
-      obj["port"] = services[i].port;
-      obj["path"] = services[i].path;
-      obj["url"] = services[i].url;
-      obj["expectedResponse"] = services[i].expectedResponse;
-      obj["checkInterval"] = services[i].checkInterval;
-      obj["passThreshold"] = services[i].passThreshold;
-      obj["failThreshold"] = services[i].failThreshold;
-      obj["rearmCount"] = services[i].rearmCount;
-      obj["consecutivePasses"] = services[i].consecutivePasses;
-      obj["consecutiveFails"] = services[i].consecutiveFails;
-      obj["failedChecksSinceAlert"] = services[i].failedChecksSinceAlert;
-      obj["isUp"] = services[i].isUp;
-      obj["secondsSinceLastCheck"] = services[i].secondsSinceLastCheck;
-      obj["lastError"] = services[i].lastError;
-      // SNMP-specific fields
-      obj["snmpOid"] = services[i].snmpOid;
-      obj["snmpCommunity"] = services[i].snmpCommunity;
-      obj["snmpCompareOp"] = getSnmpCompareOpString(services[i].snmpCompareOp);
-      obj["snmpExpectedValue"] = services[i].snmpExpectedValue;
-      // Uptime-specific fields
-      obj["uptimeThreshold"] = services[i].uptimeThreshold;
-      obj["uptimeCompareOp"] = getSnmpCompareOpString(services[i].uptimeCompareOp);
-      // Push-specific fields
-      obj["pushToken"] = services[i].pushToken;
-      // Enable/disable and pause fields
-      obj["enabled"] = services[i].enabled;
-      obj["pauseUntil"] = services[i].pauseUntil;
-      // Calculate pause remaining time in seconds (rollover-safe)
-      obj["pauseRemaining"] = getPauseRemainingMs(services[i].pauseUntil, currentTime) / 1000;
+    if (!full) {
+      JsonDocument removedDoc(&apiMemory);
+      JsonArray removed = removedDoc.to<JsonArray>();
+      for (int i = 0; i < MAX_SERVICE_TOMBSTONES; i++) {
+        if (serviceTombstones[i].version > since) {
+          removed.add(serviceTombstones[i].id);
+        }
+      }
+      response->print(",\"removed\":");
+      serializeJson(removedDoc, *response);
     }
 
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    response->print("}");
+    request->send(response);
   });
 
   // add service
@@ -2071,8 +3707,12 @@ void initWebServer() {
       if (!ensureAuthenticated(request)) {
         return;
       }
+      if (!admitBody(request, REQ_API_WRITE, index)) {
+        return;
+      }
 
-      JsonDocument doc;
+      ApiArenaRef arena = newRequestArena();
+      JsonDocument doc(arena.get());
       DeserializationError error = deserializeJson(doc, data, len);
 
       if (error) {
@@ -2080,6 +3720,12 @@ void initWebServer() {
         return;
       }
 
+      // Hold the mutex from lookup to store so the checker can't write a
+      // result into the slot while it is being replaced
+      if (!lockServicesForRequest(request)) {
+        return;
+      }
+
       // Check if this is an edit (ID provided) or a new service
       String providedId = doc["id"] | "";
       bool isEdit = (providedId.length() > 0);
@@ -2087,19 +3733,16 @@ void initWebServer() {
 
       if (isEdit) {
         // Find the existing service to edit
-        for (int i = 0; i < serviceCount; i++) {
-          if (services[i].id == providedId) {
-            editIndex = i;
-            break;
-          }
-        }
+        editIndex = findServiceIndex(providedId);
         if (editIndex == -1) {
+          xSemaphoreGive(servicesMutex);
           request->send(404, "application/json", "{\"error\":\"Service not found for editing\"}");
           return;
         }
       } else {
         // Adding a new service - check if we have space
         if (serviceCount >= MAX_SERVICES) {
+          xSemaphoreGive(servicesMutex);
           request->send(400, "application/json", "{\"error\":\"Maximum services reached\"}");
           return;
         }
@@ -2121,6 +3764,15 @@ void initWebServer() {
         newService.lastError = services[editIndex].lastError;
         newService.secondsSinceLastCheck = services[editIndex].secondsSinceLastCheck;
         newService.lastPush = services[editIndex].lastPush;
+        newService.lastPushFailed = services[editIndex].lastPushFailed;
+        newService.lastPushMessage = services[editIndex].lastPushMessage;
+        newService.latency = services[editIndex].latency;
+        newService.lastValue = services[editIndex].lastValue;
+        newService.hasValue = services[editIndex].hasValue;
+        newService.checksTotal = services[editIndex].checksTotal;
+        newService.checksFailed = services[editIndex].checksFailed;
+        memcpy(newService.errorCounts, services[editIndex].errorCounts, sizeof(newService.errorCounts));
+        newService.lastErrorCode = services[editIndex].lastErrorCode;
         newService.enabled = services[editIndex].enabled;
         newService.pauseUntil = services[editIndex].pauseUntil;
       } else {
@@ -2136,35 +3788,47 @@ void initWebServer() {
         newService.lastError = "";
         newService.secondsSinceLastCheck = -1;
         newService.lastPush = 0;
+        resetServiceTelemetry(newService);
         newService.enabled = true;
         newService.pauseUntil = 0;
       }
       
       newService.name = doc["name"].as<String>();
+      newService.tags = normalizeServiceTags(doc["tags"] | "");
+      newService.group = normalizeServiceGroup(doc["group"] | "");
+      if (findGroupSlot(newService.group) < 0 && newService.group.length() > 0 &&
+          groupAggregates.groupCount >= MAX_SERVICE_GROUPS) {
+        xSemaphoreGive(servicesMutex);
+        request->send(400, "application/json", "{\"error\":\"Maximum groups reached\"}");
+        return;
+      }
 
-      String typeStr = doc["type"].as<String>();
-      if (typeStr == "http_get") {
-        newService.type = TYPE_HTTP_GET;
-      } else if (typeStr == "ping") {
-        newService.type = TYPE_PING;
-      } else if (typeStr == "snmp_get") {
-        newService.type = TYPE_SNMP_GET;
-      } else if (typeStr == "port") {
-        newService.type = TYPE_PORT;
-      } else if (typeStr == "push") {
-        newService.type = TYPE_PUSH;
-      } else if (typeStr == "uptime") {
-        newService.type = TYPE_UPTIME;
+      int parsedType = CheckTypes::parse(doc["type"] | "");
+      if (parsedType >= 0) {
+        newService.type = (ServiceType)parsedType;
       } else {
+        xSemaphoreGive(servicesMutex);
         request->send(400, "application/json", "{\"error\":\"Invalid service type\"}");
         return;
       }
 
-      newService.host = doc["host"].as<String>();
+      // Check target strings; a failed set means the heap couldn't hold them, and a
+      // service saved without them would write empty targets to flash
+      bool configStored =
+          newService.config.set(CFG_HOST, doc["host"].as<String>()) &&
+          newService.config.set(CFG_PATH, doc["path"] | "/") &&
+          newService.config.set(CFG_URL, doc["url"].as<String>()) &&
+          newService.config.set(CFG_EXPECTED_RESPONSE, doc["expectedResponse"] | "*") &&
+          newService.config.set(CFG_SNMP_OID, doc["snmpOid"] | "") &&
+          newService.config.set(CFG_SNMP_COMMUNITY, doc["snmpCommunity"] | "public") &&
+          newService.config.set(CFG_SNMP_EXPECTED_VALUE, doc["snmpExpectedValue"] | "");
+      if (!configStored) {
+        xSemaphoreGive(servicesMutex);
+        request->send(507, "application/json", "{\"error\":\"Insufficient memory to store service\"}");
+        return;
+      }
+
       newService.port = doc["port"] | 80;
-      newService.path = doc["path"] | "/";
-      newService.url = doc["url"].as<String>();
-      newService.expectedResponse = doc["expectedResponse"] | "*";
       newService.checkInterval = doc["checkInterval"] | 60;
 
       int passThreshold = doc["passThreshold"] | 1;
@@ -2180,11 +3844,8 @@ void initWebServer() {
       newService.rearmCount = rearmCount;
 
       // SNMP-specific fields
-      newService.snmpOid = doc["snmpOid"] | "";
-      newService.snmpCommunity = doc["snmpCommunity"] | "public";
       String compareOpStr = doc["snmpCompareOp"] | "=";
       newService.snmpCompareOp = parseSnmpCompareOp(compareOpStr);
-      newService.snmpExpectedValue = doc["snmpExpectedValue"] | "";
 
       // Uptime-specific fields
       newService.uptimeThreshold = doc["uptimeThreshold"] | 86400;
@@ -2204,6 +3865,8 @@ void initWebServer() {
         newService.pushToken = "";
       }
 
+      markServiceConfigChanged(newService);
+
       // Store the service (either update existing or add new)
       if (isEdit) {
         services[editIndex] = newService;
@@ -2217,17 +3880,18 @@ void initWebServer() {
       }
       
       saveServices();
+      publishStatusSnapshot();
+      xSemaphoreGive(servicesMutex);
+      publishServiceListChanged(newService.id, "service");
 
-      JsonDocument response;
+      JsonDocument response(arena.get());
       response["success"] = true;
       response["id"] = newService.id;
       if (newService.type == TYPE_PUSH) {
         response["pushToken"] = newService.pushToken;
       }
 
-      String responseStr;
-      serializeJson(response, responseStr);
-      request->send(200, "application/json", responseStr);
+      sendArenaJson(request, arena, response);
     }
   );
 
@@ -2236,18 +3900,20 @@ void initWebServer() {
     if (!ensureAuthenticated(request)) {
       return;
     }
+    if (!admitRequest(request, REQ_API_WRITE)) {
+      return;
+    }
     String path = request->url();
     String serviceId = path.substring(path.lastIndexOf('/') + 1);
 
-    int foundIndex = -1;
-    for (int i = 0; i < serviceCount; i++) {
-      if (services[i].id == serviceId) {
-        foundIndex = i;
-        break;
-      }
+    if (!lockServicesForRequest(request)) {
+      return;
     }
 
+    int foundIndex = findServiceIndex(serviceId);
+
     if (foundIndex == -1) {
+      xSemaphoreGive(servicesMutex);
       request->send(404, "application/json", "{\"error\":\"Service not found\"}");
       return;
     }
@@ -2257,6 +3923,7 @@ void initWebServer() {
       services[i] = services[i + 1];
     }
     serviceCount--;
+    recordServiceTombstone(serviceId);
 
     // Remove history for the deleted service
     removeServiceHistory(serviceId);
@@ -2265,6 +3932,9 @@ void initWebServer() {
     removeServiceEventLog(serviceId);
 
     saveServices();
+    publishStatusSnapshot();
+    xSemaphoreGive(servicesMutex);
+    publishServiceListChanged(serviceId, "removed");
     request->send(200, "application/json", "{\"success\":true}");
   });
 
@@ -2274,6 +3944,9 @@ void initWebServer() {
       if (!ensureAuthenticated(request)) {
         return;
       }
+      if (!admitBody(request, REQ_API_WRITE, index)) {
+        return;
+      }
 
       // Extract service ID from URL path
       String path = request->url();
@@ -2281,13 +3954,8 @@ void initWebServer() {
 
       // Find the service
       int foundIndex = -1;
-      if (xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
-        for (int i = 0; i < serviceCount; i++) {
-          if (services[i].id == serviceId) {
-            foundIndex = i;
-            break;
-          }
-        }
+      if (lockServicesForRequest(request)) {
+        foundIndex = findServiceIndex(serviceId);
 
         if (foundIndex == -1) {
           xSemaphoreGive(servicesMutex);
@@ -2295,7 +3963,8 @@ void initWebServer() {
           return;
         }
 
-        JsonDocument doc;
+        ApiArenaRef arena = newRequestArena();
+        JsonDocument doc(arena.get());
         if (deserializeJson(doc, data, len) != DeserializationError::Ok) {
           xSemaphoreGive(servicesMutex);
           request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
@@ -2329,60 +3998,63 @@ void initWebServer() {
           }
         }
 
+        markServiceChanged(services[foundIndex]);
         saveServices();
+        publishStatusSnapshot();
+        publishServiceListChanged(services[foundIndex].id, "service");
 
         // Build response with current state (rollover-safe)
         unsigned long currentTimeMs = millis();
-        JsonDocument response;
+        JsonDocument response(arena.get());
         response["success"] = true;
         response["id"] = services[foundIndex].id;
         response["enabled"] = services[foundIndex].enabled;
         response["pauseUntil"] = services[foundIndex].pauseUntil;
         response["pauseRemaining"] = getPauseRemainingMs(services[foundIndex].pauseUntil, currentTimeMs) / 1000;
 
-        String responseStr;
-        serializeJson(response, responseStr);
-        request->send(200, "application/json", responseStr);
+        sendArenaJson(request, arena, response);
         
         xSemaphoreGive(servicesMutex);
-      } else {
-        request->send(500, "application/json", "{\"error\":\"Internal Server Error\"}");
-        return;
       }
     }
   );
 
   // export services configuration
   server.on("/api/export", HTTP_GET, [](AsyncWebServerRequest *request) {
-    JsonDocument doc;
+    if (!admitRequest(request, REQ_API_READ)) {
+      return;
+    }
+    JsonDocument doc(&configMemory);
     JsonArray array = doc["services"].to<JsonArray>();
 
-    if (xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
-      for (int i = 0; i < serviceCount; i++) {
-        JsonObject obj = array.add<JsonObject>();
-        obj["name"] = services[i].name;
-        obj["type"] = getServiceTypeString(services[i].type);
-        obj["host"] = services[i].host;
-        obj["port"] = services[i].port;
-        obj["path"] = services[i].path;
-        obj["url"] = services[i].url;
-        obj["expectedResponse"] = services[i].expectedResponse;
-        obj["checkInterval"] = services[i].checkInterval;
-        obj["passThreshold"] = services[i].passThreshold;
-        obj["failThreshold"] = services[i].failThreshold;
-        obj["rearmCount"] = services[i].rearmCount;
-        // SNMP-specific fields
-        obj["snmpOid"] = services[i].snmpOid;
-        obj["snmpCommunity"] = services[i].snmpCommunity;
-        obj["snmpCompareOp"] = getSnmpCompareOpString(services[i].snmpCompareOp);
-        obj["snmpExpectedValue"] = services[i].snmpExpectedValue;
-        // Push-specific fields (token is regenerated on import for security)
-        // We don't export the token, just the type
+    StatusSnapshotReader snapshot;
+    for (int i = 0; i < snapshot->count; i++) {
+      const ServiceInfo& service = *snapshot->services[i].info;
+      JsonObject obj = array.add<JsonObject>();
+      obj["name"] = service.name;
+      if (service.tags.length() > 0) {
+        obj["tags"] = service.tags;
       }
-      xSemaphoreGive(servicesMutex);
-    } else {
-      request->send(500, "application/json", "{\"error\":\"Internal Server Error\"}");
-      return;
+      if (service.group.length() > 0) {
+        obj["group"] = service.group;
+      }
+      obj["type"] = getServiceTypeString(service.type);
+      obj["host"] = service.config.get(CFG_HOST);
+      obj["port"] = service.port;
+      obj["path"] = service.config.get(CFG_PATH);
+      obj["url"] = service.config.get(CFG_URL);
+      obj["expectedResponse"] = service.config.get(CFG_EXPECTED_RESPONSE);
+      obj["checkInterval"] = service.checkInterval;
+      obj["passThreshold"] = service.passThreshold;
+      obj["failThreshold"] = service.failThreshold;
+      obj["rearmCount"] = service.rearmCount;
+      // SNMP-specific fields
+      obj["snmpOid"] = service.config.get(CFG_SNMP_OID);
+      obj["snmpCommunity"] = service.config.get(CFG_SNMP_COMMUNITY);
+      obj["snmpCompareOp"] = getSnmpCompareOpString(service.snmpCompareOp);
+      obj["snmpExpectedValue"] = service.config.get(CFG_SNMP_EXPECTED_VALUE);
+      // Push-specific fields (token is regenerated on import for security)
+      // We don't export the token, just the type
     }
 
     String response;
@@ -2399,13 +4071,16 @@ void initWebServer() {
       if (!ensureAuthenticated(request)) {
         return;
       }
+      if (!admitBody(request, REQ_API_WRITE, index)) {
+        return;
+      }
       // Limit payload size to 16KB to prevent DoS
       if (total > 16384) {
         request->send(400, "application/json", "{\"error\":\"Payload too large\"}");
         return;
       }
 
-      JsonDocument doc;
+      JsonDocument doc(&configMemory);
       DeserializationError error = deserializeJson(doc, data, len);
 
       if (error) {
@@ -2421,8 +4096,9 @@ void initWebServer() {
 
       int importedCount = 0;
       int skippedCount = 0;
+      bool outOfMemory = false;
 
-      if (xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
+      if (lockServicesForRequest(request)) {
         for (JsonObject obj : array) {
         if (serviceCount >= MAX_SERVICES) {
           skippedCount++;
@@ -2432,35 +4108,20 @@ void initWebServer() {
         // Validate required fields
         String name = obj["name"].as<String>();
         String host = obj["host"].as<String>();
-        String typeStr = obj["type"].as<String>();
+        int parsedType = CheckTypes::parse(obj["type"] | "");
         
-        // Push type doesn't require host
-        if (name.length() == 0) {
+        // Unknown or compiled-out types are skipped
+        if (name.length() == 0 || parsedType < 0) {
           skippedCount++;
           continue;
         }
         
-        // Non-push types require host
-        if (typeStr != "push" && host.length() == 0) {
-          skippedCount++;
-          continue;
-        }
-
-        ServiceType type;
-        if (typeStr == "http_get") {
-          type = TYPE_HTTP_GET;
-        } else if (typeStr == "ping") {
-          type = TYPE_PING;
-        } else if (typeStr == "snmp_get") {
-          type = TYPE_SNMP_GET;
-        } else if (typeStr == "port") {
-          type = TYPE_PORT;
-        } else if (typeStr == "push") {
-          type = TYPE_PUSH;
-        } else {
+        // Network checks require host
+        if ((CheckTypes::flags(parsedType) & CHECK_NEEDS_HOST) && host.length() == 0) {
           skippedCount++;
           continue;
         }
+        ServiceType type = (ServiceType)parsedType;
 
         // Validate and constrain numeric values
         int port = obj["port"] | 80;
@@ -2481,27 +4142,39 @@ void initWebServer() {
         Service newService;
         newService.id = generateServiceId();
         newService.name = name;
+        newService.tags = normalizeServiceTags(obj["tags"] | "");
+        newService.group = normalizeServiceGroup(obj["group"] | "");
         newService.type = type;
-        newService.host = host;
-        newService.port = port;
-        newService.path = obj["path"] | "/";
-        newService.url = obj["url"] | "";
+        bool configStored =
+            newService.config.set(CFG_HOST, host) &&
+            newService.config.set(CFG_PATH, obj["path"] | "/") &&
+            newService.config.set(CFG_URL, obj["url"] | "") &&
+            newService.config.set(CFG_EXPECTED_RESPONSE, obj["expectedResponse"] | "*") &&
+            newService.config.set(CFG_SNMP_OID, obj["snmpOid"] | "") &&
+            newService.config.set(CFG_SNMP_COMMUNITY, obj["snmpCommunity"] | "public") &&
+            newService.config.set(CFG_SNMP_EXPECTED_VALUE, obj["snmpExpectedValue"] | "");
         // Backward compatibility: generate URL from host/port/path if URL is empty
-        if (newService.url.length() == 0 && type == TYPE_HTTP_GET && host.length() > 0) {
+        if (configStored && newService.config.length(CFG_URL) == 0 && type == TYPE_HTTP_GET && host.length() > 0) {
           String protocol = (port == 443) ? "https://" : "http://";
-          newService.url = protocol + host + ":" + String(port) + newService.path;
+          configStored = newService.config.set(CFG_URL, protocol + host + ":" + String(port) + newService.config.get(CFG_PATH));
+        }
+        if (!configStored) {
+          // Out of heap: keep what was imported so far and report the rest
+          outOfMemory = true;
+          skippedCount += array.size() - importedCount - skippedCount;
+          break;
         }
-        newService.expectedResponse = obj["expectedResponse"] | "*";
+        newService.port = port;
         newService.checkInterval = checkInterval;
         newService.passThreshold = passThreshold;
         newService.failThreshold = failThreshold;
         newService.rearmCount = rearmCount;
         // SNMP-specific fields
-        newService.snmpOid = obj["snmpOid"] | "";
-        newService.snmpCommunity = obj["snmpCommunity"] | "public";
         String compareOpStr = obj["snmpCompareOp"] | "=";
         newService.snmpCompareOp = parseSnmpCompareOp(compareOpStr);
-        newService.snmpExpectedValue = obj["snmpExpectedValue"] | "";
+        // Uptime-specific fields
+        newService.uptimeThreshold = obj["uptimeThreshold"] | 86400;
+        newService.uptimeCompareOp = parseSnmpCompareOp(obj["uptimeCompareOp"] | ">");
         // Push-specific fields - generate new token on import for security
         if (type == TYPE_PUSH) {
           newService.pushToken = generatePushToken();
@@ -2518,35 +4191,46 @@ void initWebServer() {
         newService.lastUptime = 0;
         newService.lastError = "";
         newService.secondsSinceLastCheck = -1;
+        resetServiceTelemetry(newService);
         // Enable/disable and pause fields - import as enabled and not paused
         newService.enabled = true;
         newService.pauseUntil = 0;
+        markServiceConfigChanged(newService);
 
         services[serviceCount++] = newService;
         importedCount++;
       }
 
       saveServices();
+      publishStatusSnapshot();
       xSemaphoreGive(servicesMutex);
+      if (importedCount > 0) {
+        publishServiceListChanged("", "service");
+      }
     } else {
-      request->send(500, "application/json", "{\"error\":\"Internal Server Error\"}");
       return;
     }
 
-      JsonDocument response;
-      response["success"] = true;
+      JsonDocument response(&configMemory);
+      response["success"] = !outOfMemory;
       response["imported"] = importedCount;
       response["skipped"] = skippedCount;
+      if (outOfMemory) {
+        response["error"] = "Insufficient memory to store remaining services";
+      }
 
       String responseStr;
       serializeJson(response, responseStr);
-      request->send(200, "application/json", responseStr);
+      request->send(outOfMemory ? 507 : 200, "application/json", responseStr);
     }
   );
 
   // Push endpoint for push-based monitoring
-  // Clients send a GET request to /api/push/{token} to register a check pass
+  // Clients send a GET request to /api/push/{token} to register a check result
   server.on("/api/push/*", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!admitRequest(request, REQ_PUSH)) {
+      return;
+    }
     String path = request->url();
     String token = path.substring(path.lastIndexOf('/') + 1);
     
@@ -2555,64 +4239,96 @@ void initWebServer() {
       return;
     }
     
-    // Find the service with this push token
-    bool found = false;
-    if (xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
-      for (int i = 0; i < serviceCount; i++) {
-        if (services[i].type == TYPE_PUSH && services[i].pushToken == token) {
-          unsigned long now = millis();
-          services[i].lastPush = now;
-          bool wasUp = services[i].isUp;
-
-          // Mark the service as passing immediately
-          services[i].lastCheck = now;
-          services[i].lastUptime = now;
-          services[i].secondsSinceLastCheck = 0;
-          services[i].consecutiveFails = 0;
-          services[i].failedChecksSinceAlert = 0;
-          services[i].lastError = "";
-
-          int requiredPasses = services[i].passThreshold >= 1 ? services[i].passThreshold : 1;
-          services[i].consecutivePasses = requiredPasses;
-          services[i].isUp = true;
-
-          if (!wasUp) {
-            Serial.printf("Push service '%s' marked UP immediately\n", services[i].name.c_str());
-
-  #ifdef HAS_LCD
-            displayNeedsUpdate = true;
-  #endif
-
-            if (services[i].hasBeenUp) {
-              sendOnlineNotification(services[i]);
-            }
-            services[i].hasBeenUp = true;
-          }
-          found = true;
-          Serial.printf("Push received for service '%s'\n", services[i].name.c_str());
-          
-          JsonDocument response;
-          response["success"] = true;
-          response["service"] = services[i].name;
-          response["timestamp"] = services[i].lastPush;
-          
-          String responseStr;
-          serializeJson(response, responseStr);
-          request->send(200, "application/json", responseStr);
-          
-          xSemaphoreGive(servicesMutex);
-          return;
-        }
+    int index = findPushServiceIndex(token);
+    if (index == -1) {
+      request->send(404, "application/json", "{\"error\":\"Invalid push token\"}");
+      return;
+    }
+
+    // Optional payload:
+    //   status=up|down  - report the job outcome (default: up)
+    //   msg=<text>      - shown as the error when down
+    //   value=<number>  - checked against the service's comparison/expected value
+    //   duration=<ms>   - job run time, added to the latency histogram
+    PushEvent event;
+    event.reportedDown = false;
+    event.hasValue = false;
+    event.hasDuration = false;
+    event.value = 0;
+    event.durationMs = 0;
+    event.valueText[0] = '\0';
+    event.message[0] = '\0';
+
+    if (request->hasParam("status")) {
+      String status = request->getParam("status")->value();
+      status.toLowerCase();
+      if (status == "down") {
+        event.reportedDown = true;
+      } else if (status != "up") {
+        request->send(400, "application/json", "{\"error\":\"status must be up or down\"}");
+        return;
       }
-      xSemaphoreGive(servicesMutex);
-    } else {
-      request->send(500, "application/json", "{\"error\":\"Internal Server Error\"}");
+    }
+    if (request->hasParam("value")) {
+      String valueStr = request->getParam("value")->value();
+      char* end = nullptr;
+      event.value = strtof(valueStr.c_str(), &end);
+      if (valueStr.length() == 0 || valueStr.length() >= sizeof(event.valueText) || *end != '\0') {
+        request->send(400, "application/json", "{\"error\":\"value must be a number\"}");
+        return;
+      }
+      strncpy(event.valueText, valueStr.c_str(), sizeof(event.valueText));
+      event.hasValue = true;
+    }
+    if (request->hasParam("duration")) {
+      String durationStr = request->getParam("duration")->value();
+      char* end = nullptr;
+      float duration = strtof(durationStr.c_str(), &end);
+      if (durationStr.length() == 0 || *end != '\0' || duration < 0) {
+        request->send(400, "application/json", "{\"error\":\"duration must be a non-negative number of milliseconds\"}");
+        return;
+      }
+      event.durationMs = duration > 4000000000.0f ? 4000000000UL : (uint32_t)duration;
+      event.hasDuration = true;
+    }
+    if (request->hasParam("msg")) {
+      strncpy(event.message, request->getParam("msg")->value().c_str(), sizeof(event.message) - 1);
+      event.message[sizeof(event.message) - 1] = '\0';
+    }
+
+    // Hand the push to the aggregator task and answer straight away; the service
+    // state is updated (and any recovery notification queued) by processPushQueue()
+    event.serviceIndex = index;
+    event.tokenHash = fnv1aHash(token.c_str(), token.length());
+    event.receivedAt = millis();
+    if (!pushQueue.tryPush(event)) {
+      AsyncWebServerResponse *response = request->beginResponse(503, "application/json", "{\"error\":\"Push queue full\"}");
+      response->addHeader("Retry-After", "1");
+      request->send(response);
       return;
     }
-    
-    if (!found) {
-      request->send(404, "application/json", "{\"error\":\"Invalid push token\"}");
+    wakeAggregator();
+
+    // services[] is only read under servicesMutex; the name comes from the snapshot,
+    // checked against the token in case the list changed since the lookup
+    String serviceName;
+    {
+      StatusSnapshotReader snapshot;
+      if (index < snapshot->count && snapshot->services[index].info->pushToken == token) {
+        serviceName = snapshot->services[index].info->name;
+      }
+    }
+
+    ApiArenaRef arena = newRequestArena();
+    JsonDocument response(arena.get());
+    response["success"] = true;
+    response["queued"] = true;
+    if (serviceName.length() > 0) {
+      response["service"] = serviceName;
     }
+    response["timestamp"] = event.receivedAt;
+
+    sendArenaJson(request, arena, response);
   });
 
   // Clear history for a specific service
@@ -2620,6 +4336,9 @@ void initWebServer() {
     if (!ensureAuthenticated(request)) {
       return;
     }
+    if (!admitRequest(request, REQ_API_WRITE)) {
+      return;
+    }
     
     // Get service ID from query parameter
     if (!request->hasParam("id")) {
@@ -2634,19 +4353,13 @@ void initWebServer() {
       return;
     }
     
-    // Verify service exists
-    bool found = false;
-    if (xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
-      for (int i = 0; i < serviceCount; i++) {
-        if (services[i].id == serviceId) {
-          found = true;
-          break;
-        }
-      }
-      xSemaphoreGive(servicesMutex);
+    // The whole clear runs under servicesMutex: the aggregator records results into
+    // the same entry and history index. history.json is written by the aggregator.
+    if (!lockServicesForRequest(request)) {
+      return;
     }
-    
-    if (!found) {
+    if (findServiceIndex(serviceId) == -1) {
+      xSemaphoreGive(servicesMutex);
       request->send(404, "application/json", "{\"error\":\"Service not found\"}");
       return;
     }
@@ -2668,17 +4381,22 @@ void initWebServer() {
       unsigned long currentHour = (now / 3600) * 3600;
       serviceHistories[historyIndex].currentHourStart = currentHour;
       serviceHistories[historyIndex].firstHourTimestamp = currentHour;
+      markHistoryChanged(serviceHistories[historyIndex]);
+      historySaveRequested = true;
+    }
+    xSemaphoreGive(servicesMutex);
 
-      saveHistory();
+    if (historyIndex != -1) {
+      wakeAggregator();
+      publishHistoryChanged(serviceId);
     }
     
-    JsonDocument response;
+    ApiArenaRef arena = newRequestArena();
+    JsonDocument response(arena.get());
     response["success"] = true;
     response["message"] = "History cleared";
     
-    String responseStr;
-    serializeJson(response, responseStr);
-    request->send(200, "application/json", responseStr);
+    sendArenaJson(request, arena, response);
   });
 
 #ifdef HAS_LCD
@@ -2700,8 +4418,86 @@ void initWebServer() {
   });
 #endif
 
+  // Get windowed history for many services in one response
+  // GET /api/histories?ids=<id>,<id>&hours=<1..720>&step=<1..24>
+  //   ids   - optional comma-separated service IDs (default: all services)
+  //   hours - trailing window to return (default: DISPLAY_HISTORY_HOURS)
+  //   step  - average every N hourly buckets into one value (default: 1, no downsampling)
+  // Registered as /api/histories so it isn't shadowed by the /api/history/* wildcard.
+  server.on("/api/histories", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!admitRequest(request, REQ_API_READ)) {
+      return;
+    }
+    int hours = DISPLAY_HISTORY_HOURS;
+    if (request->hasParam("hours")) {
+      hours = request->getParam("hours")->value().toInt();
+      if (hours < 1) hours = 1;
+      if (hours > MAX_HISTORY_HOURS) hours = MAX_HISTORY_HOURS;
+    }
+    int step = 1;
+    if (request->hasParam("step")) {
+      step = request->getParam("step")->value().toInt();
+      if (step < 1) step = 1;
+      if (step > 24) step = 24;
+    }
+    // Coarser buckets under memory pressure; the response echoes the step used
+    if (step < currentPressurePolicy().minHistoryStep) {
+      step = currentPressurePolicy().minHistoryStep;
+    }
+
+    // Every history change bumps historyVersion. The effective hours and step are
+    // in the tag as well, since the pressure floor can change the step for the same
+    // URL, and so are the ids, so the tag never depends on the browser's cache key.
+    String ids = request->hasParam("ids") ? request->getParam("ids")->value() : String();
+    String etag = makeEtag('H', historyVersion.load(),
+                           "-" + String(hours) + "-" + String(step) + "-" +
+                           String((unsigned long)fnv1aHash(ids.c_str(), ids.length())));
+    if (sendNotModifiedIfMatch(request, etag)) {
+      return;
+    }
+
+    if (!lockServicesForRequest(request)) {
+      return;
+    }
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    response->printf("{\"hours\":%d,\"step\":%d,\"histories\":[", hours, step);
+
+    bool first = true;
+    if (request->hasParam("ids")) {
+      int start = 0;
+      while (start <= (int)ids.length()) {
+        int comma = ids.indexOf(',', start);
+        if (comma < 0) comma = ids.length();
+        String serviceId = ids.substring(start, comma);
+        start = comma + 1;
+
+        int historyIndex = serviceId.length() > 0 ? getHistoryIndex(serviceId) : -1;
+        if (historyIndex == -1) continue;
+        if (!first) response->print(",");
+        writeHistoryWindowJson(*response, historyIndex, hours, step);
+        first = false;
+      }
+    } else {
+      for (int i = 0; i < MAX_SERVICES; i++) {
+        if (serviceHistories[i].serviceId.length() == 0) continue;
+        if (!first) response->print(",");
+        writeHistoryWindowJson(*response, i, hours, step);
+        first = false;
+      }
+    }
+    xSemaphoreGive(servicesMutex);
+
+    response->print("]}");
+    request->send(response);
+  });
+
   // Get historical data for a specific service
   server.on("/api/history/*", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!admitRequest(request, REQ_API_READ)) {
+      return;
+    }
     String path = request->url();
     String serviceId = path.substring(path.lastIndexOf('/') + 1);
     
@@ -2710,14 +4506,30 @@ void initWebServer() {
       return;
     }
     
-    // Find the history for this service
+    // The aggregator appends to the entry from the other core, so it is copied into
+    // the document under the lock and sent after the lock is released
+    if (!lockServicesForRequest(request)) {
+      return;
+    }
     int historyIndex = getHistoryIndex(serviceId);
     if (historyIndex == -1) {
+      xSemaphoreGive(servicesMutex);
       request->send(404, "application/json", "{\"error\":\"Service history not found\"}");
       return;
     }
+
+    // The body also carries the current hour's counters, so they are part of the
+    // tag; polls within the same check interval still end here
+    const ServiceHistory& current = serviceHistories[historyIndex];
+    String etag = makeEtag('h', current.version,
+                           "-" + String(current.checksThisHour) + "-" + String(current.passesThisHour));
+    if (sendNotModifiedIfMatch(request, etag)) {
+      xSemaphoreGive(servicesMutex);
+      return;
+    }
     
-    JsonDocument doc;
+    ApiArenaRef arena = newRequestArena();
+    JsonDocument doc(arena.get());
     doc["serviceId"] = serviceHistories[historyIndex].serviceId;
     doc["firstHourTimestamp"] = (unsigned long)serviceHistories[historyIndex].firstHourTimestamp;
     doc["currentHourStart"] = (unsigned long)serviceHistories[historyIndex].currentHourStart;
@@ -2743,14 +4555,16 @@ void initWebServer() {
     for (uint8_t uptime : serviceHistories[historyIndex].hourlyUptime) {
       uptimeArray.add(uptime);
     }
+    xSemaphoreGive(servicesMutex);
     
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    sendArenaJson(request, arena, doc, 200, etag);
   });
 
   // Get event log for a specific service
   server.on("/api/events/*", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!admitRequest(request, REQ_API_READ)) {
+      return;
+    }
     String path = request->url();
     String serviceId = path.substring(path.lastIndexOf('/') + 1);
     
@@ -2768,12 +4582,15 @@ void initWebServer() {
       }
     }
     
-    // Verify the service exists in the services array
+    // Verify the service exists
     bool serviceExists = false;
-    for (int i = 0; i < serviceCount; i++) {
-      if (services[i].id == serviceId) {
-        serviceExists = true;
-        break;
+    {
+      StatusSnapshotReader snapshot;
+      for (int i = 0; i < snapshot->count; i++) {
+        if (snapshot->services[i].info->id == serviceId) {
+          serviceExists = true;
+          break;
+        }
       }
     }
     
@@ -2782,48 +4599,109 @@ void initWebServer() {
       return;
     }
     
-    // Find the event log for this service
-    int eventLogIndex = getEventLogIndex(serviceId);
-    if (eventLogIndex == -1) {
-      // Return empty event log if not found (service exists but no events yet)
-      JsonDocument doc;
-      doc["serviceId"] = serviceId;
-      JsonArray eventsArray = doc["events"].to<JsonArray>();
-      String response;
-      serializeJson(doc, response);
-      request->send(200, "application/json", response);
+    ApiArenaRef arena = newRequestArena();
+    JsonDocument doc(arena.get());
+    doc["serviceId"] = serviceId;
+    JsonArray eventsArray = doc["events"].to<JsonArray>();
+
+    // The aggregator appends to the log from the other core, so the events are
+    // copied into the document under the lock. A service without a log yet (no
+    // state changes) gets an empty list.
+    if (!lockServicesForRequest(request)) {
       return;
     }
-    
-    JsonDocument doc;
-    doc["serviceId"] = serviceEventLogs[eventLogIndex].serviceId;
-    
-    // Add events array
-    JsonArray eventsArray = doc["events"].to<JsonArray>();
-    for (const ServiceEvent& event : serviceEventLogs[eventLogIndex].events) {
-      JsonObject eventObj = eventsArray.add<JsonObject>();
-      eventObj["timestamp"] = event.timestamp;
-      eventObj["isUp"] = event.isUp;
-      if (event.reason.length() > 0) {
-        eventObj["reason"] = event.reason;
+    int eventLogIndex = getEventLogIndex(serviceId);
+    if (eventLogIndex != -1) {
+      for (const ServiceEvent& event : serviceEventLogs[eventLogIndex].events) {
+        JsonObject eventObj = eventsArray.add<JsonObject>();
+        eventObj["timestamp"] = event.timestamp;
+        eventObj["isUp"] = event.isUp;
+        if (event.reason.length() > 0) {
+          eventObj["reason"] = event.reason;
+        }
       }
     }
+    xSemaphoreGive(servicesMutex);
     
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    sendArenaJson(request, arena, doc);
+  });
+
+  // group status: aggregate counts per service group plus overall totals
+  server.on("/api/groups", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!admitRequest(request, REQ_API_READ)) {
+      return;
+    }
+    StatusSnapshotReader snapshot;
+    String etag = makeEtag('g', snapshot->version);
+    if (sendNotModifiedIfMatch(request, etag)) {
+      return;
+    }
+
+    ApiArenaRef arena = newRequestArena();
+    JsonDocument doc(arena.get());
+    addGroupStatusJson(doc["totals"].to<JsonObject>(), snapshot->groups.totals);
+    JsonArray groups = doc["groups"].to<JsonArray>();
+    for (int g = 0; g < snapshot->groups.groupCount; g++) {
+      JsonObject obj = groups.add<JsonObject>();
+      obj["name"] = snapshot->groups.groups[g].name;
+      addGroupStatusJson(obj, snapshot->groups.groups[g]);
+    }
+
+    sendArenaJson(request, arena, doc, 200, etag);
+  });
+
+  // check types built into this firmware, with their type-specific fields
+  server.on("/api/check-types", HTTP_GET, [](AsyncWebServerRequest *request) {
+    if (!admitRequest(request, REQ_API_READ)) {
+      return;
+    }
+    ApiArenaRef arena = newRequestArena();
+    JsonDocument doc(arena.get());
+    JsonArray types = doc["types"].to<JsonArray>();
+    auto addType = [&](int id, const char* name, unsigned flags, const char* fields) {
+      JsonObject obj = types.add<JsonObject>();
+      obj["type"] = name;
+      obj["needsHost"] = (flags & CHECK_NEEDS_HOST) != 0;
+      obj["usesPort"] = (flags & CHECK_USES_PORT) != 0;
+      obj["passive"] = (flags & CHECK_PASSIVE) != 0;
+      obj["fields"] = fields;
+    };
+    CheckTypes::forEach(addType);
+
+    sendArenaJson(request, arena, doc);
   });
 
   // GET /api/uptime - Return ESP32 uptime in seconds
   server.on("/api/uptime", HTTP_GET, [](AsyncWebServerRequest *request) {
-    JsonDocument doc;
+    if (!admitRequest(request, REQ_API_READ)) {
+      return;
+    }
+    ApiArenaRef arena = newRequestArena();
+    JsonDocument doc(arena.get());
     doc["uptime"] = millis() / 1000;
     
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    sendArenaJson(request, arena, doc);
   });
 
+  // Live status stream (Server-Sent Events)
+  statusEvents.authorizeConnect(admitStreamConnect);
+  statusEvents.onConnect([](AsyncEventSourceClient *client) {
+    char hello[32];
+    snprintf(hello, sizeof(hello), "{\"version\":%lu}", (unsigned long)statusVersion.load());
+    client->send(hello, "hello", statusVersion.load(), 5000);
+  });
+  server.addHandler(&statusEvents);
+
+  // Heap and fragmentation history, with the TLS low-memory alert
+  server.on("/api/heap", HTTP_GET, handleHeapRequest);
+
+  // Memory pressure transitions and other system events
+  server.on("/api/system/events", HTTP_GET, handleSystemEventsRequest);
+
+  // Prometheus/OpenMetrics scrape endpoint
+  server.on("/metrics", HTTP_GET, handleMetricsRequest);
+
+#if FEATURE_OTA
   // Initialize ElegantOTA for firmware updates via web interface
   // Access the update page at /update
   // Use existing web authentication credentials if configured
@@ -2832,10 +4710,13 @@ void initWebServer() {
   } else {
     ElegantOTA.begin(&server);
   }
+#endif
   
   server.begin();
   Serial.println("Web server started");
+#if FEATURE_OTA
   Serial.println("OTA update available at: http://<ip>/update");
+#endif
 }
 
 String generateServiceId() {
@@ -2871,11 +4752,21 @@ void checkServices() {
   // We use an index-based approach but re-validate inside the lock
   int i = 0;
   while (true) {
-    Service serviceCopy;
+    CheckPlanRef plan;
+    CheckOutcome outcome;
+    bool checkResult = false;
     bool needsCheck = false;
     bool endOfList = false;
 
+    // A slow check can take seconds; send notifications the aggregator decided
+    // on meanwhile instead of holding them until the whole pass is done
+    processAlertQueue();
+
     if (xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
+      // Skip services that aren't due using only the dense schedule array
+      while (i < serviceCount && !isScheduleDue(serviceSchedules[i], currentTime)) {
+        i++;
+      }
       if (i >= serviceCount) {
         endOfList = true;
       } else {
@@ -2889,220 +4780,1709 @@ void checkServices() {
               isPaused = true;
             } else {
               services[i].pauseUntil = 0; // Clear expired pause
+              refreshServiceSchedule(i);
+              markServiceChanged(services[i]);
+              publishStatusSnapshot();
+              publishServiceCheck(services[i]);
             }
           }
 
           if (!isPaused && (currentTime - services[i].lastCheck >= services[i].checkInterval * 1000)) {
             services[i].lastCheck = currentTime; // Mark as checked to avoid immediate re-check
-            serviceCopy = services[i];
-            
-            // CRITICAL: Force deep copy of all String members to prevent COW (copy-on-write) issues
-            // Arduino String uses reference counting, so we must ensure independent copies
-            serviceCopy.id = String(serviceCopy.id.c_str());
-            serviceCopy.name = String(serviceCopy.name.c_str());
-            serviceCopy.host = String(serviceCopy.host.c_str());
-            serviceCopy.path = String(serviceCopy.path.c_str());
-            serviceCopy.url = String(serviceCopy.url.c_str());
-            serviceCopy.expectedResponse = String(serviceCopy.expectedResponse.c_str());
-            serviceCopy.lastError = String(serviceCopy.lastError.c_str());
-            serviceCopy.snmpOid = String(serviceCopy.snmpOid.c_str());
-            serviceCopy.snmpCommunity = String(serviceCopy.snmpCommunity.c_str());
-            serviceCopy.snmpExpectedValue = String(serviceCopy.snmpExpectedValue.c_str());
-            serviceCopy.pushToken = String(serviceCopy.pushToken.c_str());
-            
-            needsCheck = true;
+            refreshServiceSchedule(i);
+            // Holding a reference to the immutable plan keeps this check's config
+            // alive without copying the Service, even if it is edited or deleted
+            // while the check runs
+            plan = services[i].plan;
+            if (plan && plan->type == TYPE_PUSH) {
+              // Push state is only consistent under the lock, so judge it now
+              checkResult = checkPush(services[i], outcome);
+            }
+            needsCheck = plan != nullptr;
           }
         }
+        if (!needsCheck) {
+          refreshServiceSchedule(i);  // Entry was stale (e.g. a push moved lastCheck)
+        }
       }
       xSemaphoreGive(servicesMutex);
     } else {
       break; // Should not happen
     }
 
-    if (endOfList) break;
+    if (endOfList) break;
+
+    if (needsCheck) {
+#ifdef HAS_LCD
+      anyServiceChecked = true;
+#endif
+      // Perform the actual check against the plan
+      Serial.printf("[CHECK] %s (%s) - ", plan->serviceName.c_str(), getServiceTypeString(plan->type).c_str());
+      unsigned long checkStarted = millis();
+      
+      unsigned typeFlags = CheckTypes::flags(plan->type);
+      if (!CheckTypes::contains(plan->type)) {
+        // Saved by a build that had this type; kept so it isn't lost from services.json
+        outcome.code = CHECK_ERR_CONFIG;
+        outcome.error = "Check type not built into this firmware";
+      } else if (!(typeFlags & CHECK_PASSIVE)) {
+        // Passive (push) services were already judged while holding servicesMutex
+        checkResult = CheckTypes::probe(plan->type, *plan, outcome);
+      }
+      uint32_t checkDurationMs = millis() - checkStarted;
+      // Push and uptime checks are local bookkeeping; their latency would only be noise
+      bool hasLatency = (typeFlags & CHECK_HAS_LATENCY) != 0;
+
+      if (checkResult) {
+        Serial.println("✓ PASS");
+      } else {
+        Serial.printf("✗ FAIL: %s\n", outcome.error.c_str());
+      }
+
+      // Hand the result to the aggregator task; the executor never waits on
+      // servicesMutex for it. A full queue only means the aggregator is behind,
+      // so wake it and retry rather than drop a result.
+      CheckResultRecord record;
+      record.serviceIndex = (int16_t)i;
+      record.idHash = fnv1aHash(plan->serviceId.c_str(), plan->serviceId.length());
+      record.checkedAt = currentTime;
+      record.durationMs = checkDurationMs;
+      record.errorCode = checkResult ? CHECK_OK : outcome.code;
+      record.passed = checkResult;
+      record.hasLatency = hasLatency;
+      strncpy(record.error, outcome.error.c_str(), sizeof(record.error) - 1);
+      record.error[sizeof(record.error) - 1] = '\0';
+      while (!checkResultQueue.tryPush(record)) {
+        if (aggregatorTaskHandle == nullptr) {
+          processCheckResults();
+        } else {
+          wakeAggregator();
+          vTaskDelay(pdMS_TO_TICKS(10));
+        }
+      }
+      wakeAggregator();
+    }
+    i++;
+  }
+
+#ifdef HAS_LCD
+  // Update display if in main view and any service was checked
+  // This is done once outside the loop to avoid redundant flag setting
+  if (currentView == VIEW_MAIN && anyServiceChecked) {
+    displayNeedsUpdate = true;
+  }
+#endif
+}
+
+// ---- State Aggregator ----
+
+// Wake the aggregator task after queueing work for it
+void wakeAggregator() {
+  if (aggregatorTaskHandle != nullptr) {
+    xTaskNotifyGive(aggregatorTaskHandle);
+  }
+}
+
+// services[] index of the service whose id hashes to idHash, trying the slot it
+// was last seen in first; -1 if it is gone. Caller holds servicesMutex.
+int findServiceIndexByHash(int slot, uint32_t idHash) {
+  auto matches = [&](int index) {
+    return index >= 0 && index < serviceCount &&
+           fnv1aHash(services[index].id.c_str(), services[index].id.length()) == idHash;
+  };
+  if (matches(slot)) {
+    return slot;
+  }
+  return serviceIdIndex.find(idHash, matches);
+}
+
+// Apply one check result to its service's state machine, history and event log;
+// aggregator task only, caller holds servicesMutex
+void applyCheckResult(const CheckResultRecord& result) {
+  int idx = findServiceIndexByHash(result.serviceIndex, result.idHash);
+  if (idx == -1) {
+    return;  // Service was deleted while the check ran
+  }
+
+  // Record check result in history
+  recordCheckResult(services[idx].id, result.passed);
+  if (result.hasLatency) {
+    recordLatency(services[idx].latency, result.durationMs);
+  }
+  services[idx].checksTotal++;
+  if (!result.passed) {
+    services[idx].checksFailed++;
+    services[idx].errorCounts[result.errorCode]++;
+  }
+
+  bool wasUp = services[idx].isUp;
+
+  if (result.passed) {
+    services[idx].consecutivePasses++;
+    services[idx].consecutiveFails = 0;
+    services[idx].lastUptime = result.checkedAt;
+    services[idx].lastError = "";
+    services[idx].lastErrorCode = CHECK_OK;
+    services[idx].failedChecksSinceAlert = 0;  // Reset re-arm counter on success
+  } else {
+    services[idx].consecutiveFails++;
+    services[idx].consecutivePasses = 0;
+    services[idx].lastError = result.error; // Copy error from check
+    services[idx].lastErrorCode = result.errorCode;
+  }
+
+  // Determine new state based on thresholds
+  if (!services[idx].isUp && services[idx].consecutivePasses >= services[idx].passThreshold) {
+    // Service has passed enough times to be considered UP
+    services[idx].isUp = true;
+    services[idx].failedChecksSinceAlert = 0;  // Reset re-arm counter on recovery
+  } else if (services[idx].isUp && services[idx].consecutiveFails >= services[idx].failThreshold) {
+    // Service has failed enough times to be considered DOWN
+    services[idx].isUp = false;
+  }
+  markServiceChanged(services[idx]);
+  publishServiceCheck(services[idx]);
+
+  // Log and notify on state changes
+  if (wasUp != services[idx].isUp) {
+    Serial.printf("Service '%s' is now %s (after %d consecutive %s)\n",
+      services[idx].name.c_str(),
+      services[idx].isUp ? "UP" : "DOWN",
+      services[idx].isUp ? services[idx].consecutivePasses : services[idx].consecutiveFails,
+      services[idx].isUp ? "passes" : "fails");
+
+    // Record the state change event
+    String reason = services[idx].isUp ? 
+      String(services[idx].consecutivePasses) + " consecutive passes" :
+      String(services[idx].consecutiveFails) + " consecutive fails";
+    recordServiceEvent(services[idx].id, services[idx].isUp, reason);
+    publishServiceStateChange(services[idx], reason);
+
+#ifdef HAS_LCD
+    displayNeedsUpdate = true;
+#endif
+
+    if (!services[idx].isUp) {
+      queueAlert(idx, false);
+      services[idx].failedChecksSinceAlert = 0;  // Reset counter after initial alert
+    } else if (services[idx].hasBeenUp) {
+      // Only send online notification if service was previously UP (not initial UP after boot)
+      queueAlert(idx, true);
+    }
+    
+    // Mark that service has been UP at least once (for initial UP notification suppression)
+    if (services[idx].isUp) {
+      services[idx].hasBeenUp = true;
+    }
+  } else if (!services[idx].isUp && !result.passed && services[idx].rearmCount > 0) {
+    // Service is still DOWN and check failed - handle re-arm logic
+    services[idx].failedChecksSinceAlert++;
+    if (services[idx].failedChecksSinceAlert >= services[idx].rearmCount) {
+      Serial.printf("Service '%s' still DOWN - re-arming alert after %d failed checks\n",
+        services[idx].name.c_str(), services[idx].failedChecksSinceAlert);
+      queueAlert(idx, false);
+      services[idx].failedChecksSinceAlert = 0;  // Reset counter after re-arm alert
+    }
+  }
+
+#ifdef HAS_LCD
+  // Update display if viewing detail view and this specific service was checked
+  if (currentView == VIEW_DETAIL && idx == currentServiceIndex) {
+    displayNeedsUpdate = true;
+  }
+#endif
+}
+
+// Apply queued check results (aggregator task only). Takes servicesMutex once per
+// batch; state changes only mark the event logs dirty, and runAggregatorPass()
+// writes the file once afterwards however many services changed state.
+void processCheckResults() {
+  const int CHECK_RESULT_BATCH_SIZE = 8;
+  CheckResultRecord batch[CHECK_RESULT_BATCH_SIZE];
+
+  while (true) {
+    int batchCount = 0;
+    while (batchCount < CHECK_RESULT_BATCH_SIZE && checkResultQueue.tryPop(batch[batchCount])) {
+      batchCount++;
+    }
+    if (batchCount == 0) {
+      return;
+    }
+
+    if (xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
+      for (int b = 0; b < batchCount; b++) {
+        applyCheckResult(batch[b]);
+      }
+      publishStatusSnapshot();
+      xSemaphoreGive(servicesMutex);
+    }
+  }
+}
+
+// Ask the probe task to send an up/down notification for services[index]; caller holds servicesMutex
+void queueAlert(int index, bool isUp) {
+  AlertRequest alert;
+  alert.serviceIndex = (int16_t)index;
+  alert.idHash = fnv1aHash(services[index].id.c_str(), services[index].id.length());
+  alert.isUp = isUp;
+  if (!alertQueue.tryPush(alert)) {
+    Serial.printf("Alert queue full, dropping %s notification for '%s'\n",
+                  isUp ? "UP" : "DOWN", services[index].name.c_str());
+  }
+}
+
+// Send the notifications queued by the aggregator (probe task only). The service is
+// copied under servicesMutex and the notifiers run after it is released, so a slow
+// webhook or SMTP server never holds up checks or the web UI.
+void processAlertQueue() {
+  AlertRequest alert;
+  while (alertQueue.tryPop(alert)) {
+    Service service;
+    String groupSummary;
+    bool found = false;
+    if (xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
+      int idx = findServiceIndexByHash(alert.serviceIndex, alert.idHash);
+      if (idx != -1) {
+        service = services[idx];
+        groupSummary = describeServiceGroup(services[idx]);
+        found = true;
+      }
+      xSemaphoreGive(servicesMutex);
+    }
+    if (!found) {
+      continue;  // Deleted before the notification went out
+    }
+
+    if (alert.isUp) {
+      sendOnlineNotification(service, groupSummary);
+    } else {
+      sendOfflineNotification(service, groupSummary);
+    }
+  }
+}
+
+// Drain both queues, then write whichever files changed. The saves run without
+// servicesMutex held (they take it per entry), so flash writes never hold up the
+// web handlers that wait on it.
+void runAggregatorPass() {
+  static unsigned long lastHistorySave = 0;
+  static unsigned long lastHeapSample = 0;
+  static unsigned long lastPressureCheck = 0;
+
+  processPushQueue();
+  processCheckResults();
+
+  if (eventLogsDirty.exchange(false)) {
+    saveEventLogs();
+  }
+  if (historySaveRequested.exchange(false) || millis() - lastHistorySave >= HISTORY_SAVE_INTERVAL_MS) {
+    saveHistory();
+    lastHistorySave = millis();
+  }
+
+  if (heapSamplesTaken == 0 || millis() - lastHeapSample >= HEAP_SAMPLE_INTERVAL_MS) {
+    sampleHeap();
+    lastHeapSample = millis();
+  }
+
+  if (millis() - lastPressureCheck >= MEMORY_PRESSURE_CHECK_INTERVAL_MS) {
+    updateMemoryPressure();
+    lastPressureCheck = millis();
+  }
+}
+
+void aggregatorTask(void* parameter) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(AGGREGATOR_IDLE_WAKE_MS));
+    unsigned long passStartMicros = micros();
+    runAggregatorPass();
+    recordTaskPass(TASK_AGGREGATOR, passStartMicros);
+  }
+}
+
+// Called from setup() once services, history and event logs are loaded. If the
+// task can't be created, loop() falls back to draining the queues itself.
+void startAggregatorTask() {
+  if (xTaskCreatePinnedToCore(aggregatorTask, "aggregator", AGGREGATOR_TASK_STACK_SIZE, nullptr,
+                              AGGREGATOR_TASK_PRIORITY, &aggregatorTaskHandle,
+                              AGGREGATOR_TASK_CORE) != pdPASS) {
+    aggregatorTaskHandle = nullptr;
+    Serial.println("ERROR: Failed to start aggregator task; applying results from loop()");
+  }
+}
+
+// ---- Heap Monitor ----
+
+void readHeapRegion(uint32_t caps, HeapRegionSample& region) {
+  region.freeBytes = heap_caps_get_free_size(caps);
+  region.largestBlock = heap_caps_get_largest_free_block(caps);
+  region.minFreeBytes = heap_caps_get_minimum_free_size(caps);
+  region.fragmentationPercent = region.freeBytes > 0
+    ? (uint8_t)(100 - (uint64_t)region.largestBlock * 100 / region.freeBytes) : 0;
+}
+
+// Record one sample and update the TLS alert (aggregator task)
+void sampleHeap() {
+  HeapSample sample;
+  memset(&sample, 0, sizeof(sample));
+  sample.uptimeSeconds = millis() / 1000;
+  readHeapRegion(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, sample.internal);
+  if (PsramAllocator::psramAvailable()) {
+    readHeapRegion(MALLOC_CAP_SPIRAM, sample.psram);
+  }
+
+  portENTER_CRITICAL(&heapSamplesMux);
+  heapSamples[heapSamplesTaken % HEAP_SAMPLE_COUNT] = sample;
+  heapSamplesTaken++;
+  portEXIT_CRITICAL(&heapSamplesMux);
+
+  bool alert = heapTlsAlert;
+  if (!alert && sample.internal.largestBlock < HEAP_TLS_MIN_BLOCK_BYTES) {
+    alert = true;
+    heapTlsAlertCount++;
+    Serial.printf("WARNING: largest internal heap block %u bytes (free %u, %u%% fragmented); "
+                  "TLS handshakes for HTTPS checks and alerts may fail\n",
+                  (unsigned)sample.internal.largestBlock, (unsigned)sample.internal.freeBytes,
+                  (unsigned)sample.internal.fragmentationPercent);
+  } else if (alert && sample.internal.largestBlock >= HEAP_TLS_MIN_BLOCK_BYTES + HEAP_TLS_CLEAR_MARGIN_BYTES) {
+    alert = false;
+    Serial.printf("Heap recovered: largest internal block %u bytes\n", (unsigned)sample.internal.largestBlock);
+  }
+  if (alert != heapTlsAlert) {
+    heapTlsAlert = alert;
+#ifdef HAS_LCD
+    displayNeedsUpdate = true;
+#endif
+  }
+}
+
+// Copy of sample number seq; false if it hasn't been taken yet or was overwritten
+bool getHeapSample(uint32_t seq, HeapSample& sample) {
+  bool found = false;
+  portENTER_CRITICAL(&heapSamplesMux);
+  if (seq < heapSamplesTaken && heapSamplesTaken - seq <= (uint32_t)HEAP_SAMPLE_COUNT) {
+    sample = heapSamples[seq % HEAP_SAMPLE_COUNT];
+    found = true;
+  }
+  portEXIT_CRITICAL(&heapSamplesMux);
+  return found;
+}
+
+bool getLatestHeapSample(HeapSample& sample) {
+  return heapSamplesTaken > 0 && getHeapSample(heapSamplesTaken - 1, sample);
+}
+
+static bool isUnderPressureLevel(int level, const HeapRegionSample& internal, uint32_t margin) {
+  const MemoryPressurePolicy& policy = MEMORY_PRESSURE_POLICIES[level];
+  return internal.largestBlock < policy.minLargestBlock + margin || internal.freeBytes < policy.minFreeHeap + margin;
+}
+
+// Re-evaluate the load-shedding level from the internal heap (aggregator task).
+// Climbs straight to the worst level whose thresholds are crossed; steps down only
+// as far as the margin allows, so a heap hovering at a threshold doesn't flap.
+void updateMemoryPressure() {
+  HeapRegionSample internal;
+  readHeapRegion(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, internal);
+
+  int current = memoryPressure;
+  int level = PRESSURE_NORMAL;
+  for (int l = PRESSURE_ELEVATED; l < PRESSURE_LEVEL_COUNT; l++) {
+    if (isUnderPressureLevel(l, internal, 0)) level = l;
+  }
+  for (int l = level + 1; l <= current; l++) {
+    if (isUnderPressureLevel(l, internal, MEMORY_PRESSURE_RECOVER_MARGIN_BYTES)) level = l;
+  }
+  if (level == current) {
+    return;
+  }
+
+  memoryPressure = (MemoryPressure)level;
+  memoryPressureTransitions++;
+  recordSystemEvent("memory_pressure", "Memory pressure %s -> %s (largest block %u, free %u bytes)",
+                    MEMORY_PRESSURE_POLICIES[current].name, MEMORY_PRESSURE_POLICIES[level].name,
+                    (unsigned)internal.largestBlock, (unsigned)internal.freeBytes);
+  // Widened or restored check intervals apply from the next due check
+  if (MEMORY_PRESSURE_POLICIES[current].checkIntervalScale != MEMORY_PRESSURE_POLICIES[level].checkIntervalScale) {
+    Serial.printf("Check intervals now scaled x%u\n", (unsigned)MEMORY_PRESSURE_POLICIES[level].checkIntervalScale);
+  }
+#ifdef HAS_LCD
+  displayNeedsUpdate = true;
+#endif
+}
+
+// Append a system event to the ring, the serial log and the live stream
+void recordSystemEvent(const char* kind, const char* format, ...) {
+  SystemEvent event;
+  time_t now;
+  time(&now);
+  event.timestamp = (unsigned long)now;
+  event.uptimeSeconds = millis() / 1000;
+  event.kind = kind;
+  va_list args;
+  va_start(args, format);
+  vsnprintf(event.message, sizeof(event.message), format, args);
+  va_end(args);
+
+  portENTER_CRITICAL(&systemEventsMux);
+  systemEvents[systemEventsRecorded % SYSTEM_EVENT_COUNT] = event;
+  systemEventsRecorded++;
+  portEXIT_CRITICAL(&systemEventsMux);
+
+  Serial.printf("System event [%s]: %s\n", kind, event.message);
+  publishSystemEvent(event);
+}
+
+// GET /api/system/events: the ring, oldest first
+void handleSystemEventsRequest(AsyncWebServerRequest* request) {
+  if (!admitRequest(request, REQ_API_READ)) {
+    return;
+  }
+
+  ApiArenaRef arena = newRequestArena();
+  JsonDocument doc(arena.get());
+  doc["pressure"] = currentPressurePolicy().name;
+  JsonArray events = doc["events"].to<JsonArray>();
+  uint32_t end = systemEventsRecorded;
+  uint32_t seq = end > (uint32_t)SYSTEM_EVENT_COUNT ? end - SYSTEM_EVENT_COUNT : 0;
+  for (; seq < end; seq++) {
+    SystemEvent event;
+    portENTER_CRITICAL(&systemEventsMux);
+    bool current = systemEventsRecorded - seq <= (uint32_t)SYSTEM_EVENT_COUNT;
+    if (current) {
+      event = systemEvents[seq % SYSTEM_EVENT_COUNT];
+    }
+    portEXIT_CRITICAL(&systemEventsMux);
+    if (!current) {
+      continue;  // Overwritten while the response was being built
+    }
+    JsonObject obj = events.add<JsonObject>();
+    obj["timestamp"] = event.timestamp;
+    obj["uptime"] = event.uptimeSeconds;
+    obj["kind"] = event.kind;
+    obj["message"] = event.message;
+  }
+  sendArenaJson(request, arena, doc);
+}
+
+void addHeapRegionJson(JsonObject obj, const HeapRegionSample& region) {
+  obj["free"] = region.freeBytes;
+  obj["largestBlock"] = region.largestBlock;
+  obj["minFree"] = region.minFreeBytes;
+  obj["fragmentation"] = region.fragmentationPercent;
+}
+
+// GET /api/heap: current state and alert as a small JSON head, then the ring as
+// rows of numbers (column names in "fields"), oldest first. Rows are rendered one
+// at a time by a chunked filler, so a fragmented heap is never asked for a buffer
+// the size of the whole history.
+class HeapHistoryWriter {
+public:
+  HeapHistoryWriter(const String& head, uint32_t firstSeq, uint32_t endSeq)
+    : pending(head), offset(0), nextSeq(firstSeq), endSeq(endSeq), wroteRow(false), done(false) {}
+
+  // AwsResponseFiller body; returns 0 once everything has been sent
+  size_t fill(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+      if (offset >= pending.length()) {
+        pending = "";
+        offset = 0;
+        if (done) break;
+        renderNext();
+        continue;
+      }
+      size_t chunk = pending.length() - offset;
+      if (chunk > maxLen - written) chunk = maxLen - written;
+      memcpy(buffer + written, pending.c_str() + offset, chunk);
+      offset += chunk;
+      written += chunk;
+    }
+    return written;
+  }
+
+private:
+  String pending;
+  size_t offset;
+  uint32_t nextSeq;
+  uint32_t endSeq;
+  bool wroteRow;
+  bool done;
+
+  void renderNext() {
+    HeapSample sample;
+    // Rows overwritten since the request started are skipped
+    while (nextSeq < endSeq && !getHeapSample(nextSeq, sample)) {
+      nextSeq++;
+    }
+    if (nextSeq >= endSeq) {
+      pending = "]}";
+      done = true;
+      return;
+    }
+    nextSeq++;
+
+    char row[128];
+    snprintf(row, sizeof(row), "%s[%lu,%lu,%lu,%lu,%u,%lu,%lu,%lu,%u]", wroteRow ? "," : "",
+             (unsigned long)sample.uptimeSeconds,
+             (unsigned long)sample.internal.freeBytes, (unsigned long)sample.internal.largestBlock,
+             (unsigned long)sample.internal.minFreeBytes, (unsigned)sample.internal.fragmentationPercent,
+             (unsigned long)sample.psram.freeBytes, (unsigned long)sample.psram.largestBlock,
+             (unsigned long)sample.psram.minFreeBytes, (unsigned)sample.psram.fragmentationPercent);
+    pending = row;
+    wroteRow = true;
+  }
+};
+
+void handleHeapRequest(AsyncWebServerRequest* request) {
+  if (!admitRequest(request, REQ_API_READ)) {
+    return;
+  }
+
+  uint32_t endSeq = heapSamplesTaken;
+  uint32_t firstSeq = endSeq > (uint32_t)HEAP_SAMPLE_COUNT ? endSeq - HEAP_SAMPLE_COUNT : 0;
+
+  String head;
+  {
+    ApiArenaRef arena = newRequestArena();
+    JsonDocument doc(arena.get());
+    doc["tlsAlert"] = (bool)heapTlsAlert;
+    doc["pressure"] = currentPressurePolicy().name;
+    doc["tlsMinBlock"] = HEAP_TLS_MIN_BLOCK_BYTES;
+    doc["alerts"] = heapTlsAlertCount;
+    doc["intervalSeconds"] = HEAP_SAMPLE_INTERVAL_MS / 1000;
+    HeapSample latest;
+    if (getLatestHeapSample(latest)) {
+      addHeapRegionJson(doc["internal"].to<JsonObject>(), latest.internal);
+      if (PsramAllocator::psramAvailable()) {
+        addHeapRegionJson(doc["psram"].to<JsonObject>(), latest.psram);
+      }
+    }
+    JsonArray fields = doc["fields"].to<JsonArray>();
+    static const char* const FIELD_NAMES[] = {
+      "uptime", "internalFree", "internalLargestBlock", "internalMinFree", "internalFragmentation",
+      "psramFree", "psramLargestBlock", "psramMinFree", "psramFragmentation"
+    };
+    for (const char* name : FIELD_NAMES) {
+      fields.add(name);
+    }
+    serializeJson(doc, head);
+  }
+  // Reopen the object to append the rows
+  head.remove(head.length() - 1);
+  head += ",\"samples\":[";
+
+  std::shared_ptr<HeapHistoryWriter> writer(new HeapHistoryWriter(head, firstSeq, endSeq));
+  AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+    [writer](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+      return writer->fill(buffer, maxLen);
+    });
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+}
+
+// ---- Metrics ----
+// GET /metrics renders OpenMetrics text straight from the in-memory counters.
+// The response is chunked: each filler call renders one small block (a metric
+// family header, or one service's samples for that family) into `pending` and
+// copies out as much as fits, so the full exposition is never held in RAM.
+
+enum MetricsStage {
+  METRICS_SERVICE_UP,
+  METRICS_SERVICE_ENABLED,
+  METRICS_CHECKS,
+  METRICS_CHECK_FAILURES,
+  METRICS_CHECK_ERRORS,
+  METRICS_CHECK_DURATION,
+  METRICS_PUSH_VALUE,
+  METRICS_SYSTEM,
+  METRICS_DONE
+};
+
+String getCheckErrorString(CheckError code) {
+  switch (code) {
+    case CHECK_OK: return "none";
+    case CHECK_ERR_CONFIG: return "config";
+    case CHECK_ERR_DNS: return "dns";
+    case CHECK_ERR_CONNECT: return "connect";
+    case CHECK_ERR_TIMEOUT: return "timeout";
+    case CHECK_ERR_HTTP_STATUS: return "http_status";
+    case CHECK_ERR_MISMATCH: return "mismatch";
+    case CHECK_ERR_NO_PUSH: return "no_push";
+    case CHECK_ERR_PUSH_DOWN: return "push_down";
+    case CHECK_ERR_INTERNAL: return "internal";
+    default: return "unknown";
+  }
+}
+
+// Escape a label value per the OpenMetrics text format
+static String metricsLabelValue(const String& value) {
+  String escaped;
+  escaped.reserve(value.length() + 2);
+  for (size_t i = 0; i < value.length(); i++) {
+    char c = value[i];
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+class MetricsStreamWriter {
+public:
+  // Every family must list the same services, so the per-service values are
+  // copied from one snapshot here rather than read again for each row; a service
+  // added or deleted mid-scrape can't be emitted twice or skipped.
+  MetricsStreamWriter()
+    : stage(METRICS_SERVICE_UP), serviceIndex(0), offset(0),
+      rows(PsramStdAllocator<ServiceRow>(apiMemory)) {
+    StatusSnapshotReader snapshot;
+    unsigned long now = millis();
+    rows.resize(snapshot->count);
+    for (int i = 0; i < snapshot->count; i++) {
+      const ServiceStatus& service = snapshot->services[i];
+      ServiceRow& row = rows[i];
+      row.info = service.info;
+      row.isUp = service.isUp;
+      row.active = service.enabled && getPauseRemainingMs(service.pauseUntil, now) == 0;
+      row.checksTotal = service.checksTotal;
+      row.checksFailed = service.checksFailed;
+      memcpy(row.errorCounts, service.errorCounts, sizeof(row.errorCounts));
+      row.latency = service.latency;
+      row.hasValue = service.hasValue;
+      row.lastValue = service.lastValue;
+    }
+  }
+
+  // AwsResponseFiller body; returns 0 once everything has been sent
+  size_t fill(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+      if (offset >= pending.length()) {
+        pending = "";
+        offset = 0;
+        if (stage == METRICS_DONE) break;
+        renderNext();
+        continue;
+      }
+      size_t chunk = pending.length() - offset;
+      if (chunk > maxLen - written) chunk = maxLen - written;
+      memcpy(buffer + written, pending.c_str() + offset, chunk);
+      offset += chunk;
+      written += chunk;
+    }
+    return written;
+  }
+
+private:
+  struct ServiceRow {
+    ServiceInfoRef info;  // Labels
+    bool isUp;
+    bool active;          // Enabled and not paused
+    uint32_t checksTotal;
+    uint32_t checksFailed;
+    uint32_t errorCounts[CHECK_ERROR_COUNT];
+    LatencyHistogram latency;
+    bool hasValue;
+    float lastValue;
+  };
+
+  int stage;
+  int serviceIndex;
+  String pending;
+  size_t offset;
+  std::vector<ServiceRow, PsramStdAllocator<ServiceRow> > rows;
+
+  void family(const char* name, const char* type, const char* help) {
+    pending += "# TYPE ";
+    pending += name;
+    pending += " ";
+    pending += type;
+    pending += "\n# HELP ";
+    pending += name;
+    pending += " ";
+    pending += help;
+    pending += "\n";
+  }
+
+  void sample(const char* name, const String& labels, const String& value) {
+    pending += name;
+    if (labels.length() > 0) {
+      pending += "{";
+      pending += labels;
+      pending += "}";
+    }
+    pending += " ";
+    pending += value;
+    pending += "\n";
+  }
+
+  static String taskLabels(const TaskStats& stats) {
+    return String("task=\"") + stats.name + "\",core=\"" + String(stats.core) + "\"";
+  }
+
+  void renderNext() {
+    if (stage == METRICS_SYSTEM) {
+      renderSystem();
+      stage = METRICS_DONE;
+      return;
+    }
+
+    if (serviceIndex == 0) {
+      switch (stage) {
+        case METRICS_SERVICE_UP:
+          family("uptime_monitor_service_up", "gauge", "Whether the service is currently considered UP.");
+          break;
+        case METRICS_SERVICE_ENABLED:
+          family("uptime_monitor_service_enabled", "gauge", "Whether checks are enabled and not paused.");
+          break;
+        case METRICS_CHECKS:
+          family("uptime_monitor_checks", "counter", "Check results applied since boot.");
+          break;
+        case METRICS_CHECK_FAILURES:
+          family("uptime_monitor_check_failures", "counter", "Failed check results since boot.");
+          break;
+        case METRICS_CHECK_ERRORS:
+          family("uptime_monitor_check_errors", "counter", "Failed check results by error class since boot.");
+          break;
+        case METRICS_CHECK_DURATION:
+          family("uptime_monitor_check_duration_seconds", "histogram", "Active check duration, or duration reported by push.");
+          break;
+        case METRICS_PUSH_VALUE:
+          family("uptime_monitor_push_value", "gauge", "Last value reported by a push monitor.");
+          break;
+      }
+    }
+
+    if (serviceIndex < (int)rows.size()) {
+      renderService(rows[serviceIndex]);
+      serviceIndex++;
+    } else {
+      stage++;
+      serviceIndex = 0;
+    }
+  }
+
+  void renderService(const ServiceRow& service) {
+    String labels = "service_id=\"" + metricsLabelValue(service.info->id) +
+                    "\",service=\"" + metricsLabelValue(service.info->name) +
+                    "\",type=\"" + getServiceTypeString(service.info->type) + "\"";
+
+    switch (stage) {
+      case METRICS_SERVICE_UP:
+        sample("uptime_monitor_service_up", labels, service.isUp ? "1" : "0");
+        break;
+      case METRICS_SERVICE_ENABLED:
+        sample("uptime_monitor_service_enabled", labels, service.active ? "1" : "0");
+        break;
+      case METRICS_CHECKS:
+        sample("uptime_monitor_checks_total", labels, String(service.checksTotal));
+        break;
+      case METRICS_CHECK_FAILURES:
+        sample("uptime_monitor_check_failures_total", labels, String(service.checksFailed));
+        break;
+      case METRICS_CHECK_ERRORS:
+        for (int code = 0; code < CHECK_ERROR_COUNT; code++) {
+          if (service.errorCounts[code] == 0) continue;
+          sample("uptime_monitor_check_errors_total",
+                 labels + ",code=\"" + getCheckErrorString((CheckError)code) + "\"",
+                 String(service.errorCounts[code]));
+        }
+        break;
+      case METRICS_CHECK_DURATION: {
+        const LatencyHistogram& histogram = service.latency;
+        if (histogram.count == 0) break;
+        uint32_t cumulative = 0;
+        for (int b = 0; b < LATENCY_BUCKET_COUNT; b++) {
+          cumulative += histogram.buckets[b];
+          String le = b < LATENCY_BUCKET_COUNT - 1 ? String(LATENCY_BUCKET_BOUNDS_MS[b] / 1000.0f, 3) : String("+Inf");
+          sample("uptime_monitor_check_duration_seconds_bucket", labels + ",le=\"" + le + "\"", String(cumulative));
+        }
+        sample("uptime_monitor_check_duration_seconds_count", labels, String(histogram.count));
+        sample("uptime_monitor_check_duration_seconds_sum", labels, String((double)histogram.sumMs / 1000.0, 3));
+        break;
+      }
+      case METRICS_PUSH_VALUE:
+        if (service.hasValue) {
+          sample("uptime_monitor_push_value", labels, String(service.lastValue, 4));
+        }
+        break;
+    }
+  }
+
+  void renderSystem() {
+    // Other tasks write the queue depth and task counters; copy them in one go
+    NotificationQueueDepth depth;
+    TaskStats tasks[TASK_SLOT_COUNT];
+    portENTER_CRITICAL(&notificationQueueDepthMux);
+    depth = notificationQueueDepth;
+    portEXIT_CRITICAL(&notificationQueueDepthMux);
+    portENTER_CRITICAL(&taskStatsMux);
+    memcpy(tasks, taskStats, sizeof(tasks));
+    portEXIT_CRITICAL(&taskStatsMux);
+
+    family("uptime_monitor_notification_queue_depth", "gauge", "Notifications waiting for retry, by channel.");
+    sample("uptime_monitor_notification_queue_depth", "channel=\"ntfy\"", String(depth.ntfy));
+    sample("uptime_monitor_notification_queue_depth", "channel=\"discord\"", String(depth.discord));
+    sample("uptime_monitor_notification_queue_depth", "channel=\"smtp\"", String(depth.smtp));
+    sample("uptime_monitor_notification_queue_depth", "channel=\"meshcore\"", String(depth.mesh));
+
+    family("uptime_monitor_push_queue_depth", "gauge", "Pushes accepted but not yet applied.");
+    sample("uptime_monitor_push_queue_depth", "", String((uint32_t)pushQueue.sizeApprox()));
+
+    family("uptime_monitor_check_result_queue_depth", "gauge", "Check results waiting for the aggregator task.");
+    sample("uptime_monitor_check_result_queue_depth", "", String((uint32_t)checkResultQueue.sizeApprox()));
+
+    static const char* const rejectReasons[REJECT_REASON_COUNT] = {"rate", "heap", "concurrency", "pressure"};
+    family("uptime_monitor_http_rejected_requests", "counter", "Web requests refused by admission control.");
+    for (int c = 0; c < REQ_CLASS_COUNT; c++) {
+      for (int r = 0; r < REJECT_REASON_COUNT; r++) {
+        sample("uptime_monitor_http_rejected_requests_total",
+               String("class=\"") + ADMISSION_POLICIES[c].name + "\",reason=\"" + rejectReasons[r] + "\"",
+               String(admissionRejections[c][r]));
+      }
+    }
+    family("uptime_monitor_http_in_flight_requests", "gauge", "Web requests currently holding a concurrency slot.");
+    for (int c = 0; c < REQ_CLASS_COUNT; c++) {
+      if (ADMISSION_POLICIES[c].maxInFlight == 0) continue;
+      uint32_t inFlight = c == REQ_STREAM ? (uint32_t)statusEvents.count() : (uint32_t)requestsInFlight[c];
+      sample("uptime_monitor_http_in_flight_requests",
+             String("class=\"") + ADMISSION_POLICIES[c].name + "\"", String(inFlight));
+    }
+
+    family("uptime_monitor_heap_free_bytes", "gauge", "Free internal heap.");
+    sample("uptime_monitor_heap_free_bytes", "", String(ESP.getFreeHeap()));
+    family("uptime_monitor_heap_min_free_bytes", "gauge", "Lowest free internal heap since boot.");
+    sample("uptime_monitor_heap_min_free_bytes", "", String(ESP.getMinFreeHeap()));
+    family("uptime_monitor_heap_largest_free_block_bytes", "gauge", "Largest allocatable internal heap block.");
+    sample("uptime_monitor_heap_largest_free_block_bytes", "", String(ESP.getMaxAllocHeap()));
+    if (ESP.getPsramSize() > 0) {
+      family("uptime_monitor_psram_free_bytes", "gauge", "Free PSRAM.");
+      sample("uptime_monitor_psram_free_bytes", "", String(ESP.getFreePsram()));
+    }
+    HeapSample latest;
+    if (getLatestHeapSample(latest)) {
+      family("uptime_monitor_heap_fragmentation_percent", "gauge", "100 * (1 - largest free block / free), from the heap monitor.");
+      sample("uptime_monitor_heap_fragmentation_percent", "region=\"internal\"", String(latest.internal.fragmentationPercent));
+      if (PsramAllocator::psramAvailable()) {
+        sample("uptime_monitor_heap_fragmentation_percent", "region=\"psram\"", String(latest.psram.fragmentationPercent));
+        family("uptime_monitor_psram_largest_free_block_bytes", "gauge", "Largest allocatable PSRAM block.");
+        sample("uptime_monitor_psram_largest_free_block_bytes", "", String(latest.psram.largestBlock));
+        family("uptime_monitor_psram_min_free_bytes", "gauge", "Lowest free PSRAM since boot.");
+        sample("uptime_monitor_psram_min_free_bytes", "", String(latest.psram.minFreeBytes));
+      }
+    }
+    family("uptime_monitor_heap_tls_alert", "gauge", "1 while the largest internal block is too small for a TLS handshake.");
+    sample("uptime_monitor_heap_tls_alert", "", heapTlsAlert ? "1" : "0");
+    family("uptime_monitor_heap_tls_alerts", "counter", "Times the TLS low-memory alert has been raised.");
+    sample("uptime_monitor_heap_tls_alerts_total", "", String(heapTlsAlertCount));
+    family("uptime_monitor_memory_pressure_level", "gauge", "Load-shedding level: 0 normal, 1 elevated, 2 high, 3 critical.");
+    sample("uptime_monitor_memory_pressure_level", "", String((int)memoryPressure));
+    family("uptime_monitor_memory_pressure_transitions", "counter", "Memory pressure level changes since boot.");
+    sample("uptime_monitor_memory_pressure_transitions_total", "", String(memoryPressureTransitions));
+
+    const TaskStats& loopStats = tasks[TASK_LOOP];
+    family("uptime_monitor_memory_pool_bytes", "gauge", "Heap bytes held by each subsystem's pool, by region.");
+    for (int p = 0; p < MEMORY_POOL_COUNT; p++) {
+      String pool = String("pool=\"") + MEMORY_POOLS[p]->name() + "\"";
+      sample("uptime_monitor_memory_pool_bytes", pool + ",region=\"internal\"",
+             String((uint32_t)MEMORY_POOLS[p]->internalBytes()));
+      sample("uptime_monitor_memory_pool_bytes", pool + ",region=\"psram\"",
+             String((uint32_t)MEMORY_POOLS[p]->psramBytes()));
+    }
+    family("uptime_monitor_memory_pool_peak_bytes", "gauge", "Most bytes each subsystem's pool has held at once.");
+    for (int p = 0; p < MEMORY_POOL_COUNT; p++) {
+      sample("uptime_monitor_memory_pool_peak_bytes", String("pool=\"") + MEMORY_POOLS[p]->name() + "\"",
+             String((uint32_t)MEMORY_POOLS[p]->peakBytes()));
+    }
+    if (PsramAllocator::psramAvailable()) {
+      family("uptime_monitor_memory_pool_psram_fallbacks", "counter", "Allocations that found PSRAM full and used internal heap.");
+      for (int p = 0; p < MEMORY_POOL_COUNT; p++) {
+        sample("uptime_monitor_memory_pool_psram_fallbacks_total", String("pool=\"") + MEMORY_POOLS[p]->name() + "\"",
+               String(MEMORY_POOLS[p]->psramFallbacks()));
+      }
+    }
+
+    family("uptime_monitor_request_arena_free_slabs", "gauge", "Request arena slabs not lent to an in-flight request.");
+    sample("uptime_monitor_request_arena_free_slabs", "", String((uint32_t)requestSlabs.freeCount()));
+    family("uptime_monitor_request_arena_peak_slabs", "gauge", "Most request arena slabs in use at once.");
+    sample("uptime_monitor_request_arena_peak_slabs", "", String((uint32_t)requestSlabs.peakSlabsInUse()));
+    family("uptime_monitor_request_arena_overflows", "counter", "Request allocations that did not fit the arena and used the heap.");
+    sample("uptime_monitor_request_arena_overflows_total", "", String(requestSlabs.overflowCount()));
+    family("uptime_monitor_service_json_cache_hits", "counter", "Cached /api/services fragments reused without serializing.");
+    sample("uptime_monitor_service_json_cache_hits_total", "", String(serviceJsonCacheHits));
+    family("uptime_monitor_service_json_cache_misses", "counter", "/api/services fragments serialized after a config or state change.");
+    sample("uptime_monitor_service_json_cache_misses_total", "", String(serviceJsonCacheMisses));
+
+    family("uptime_monitor_loop_iterations", "counter", "Main loop iterations since boot.");
+    sample("uptime_monitor_loop_iterations_total", "", String(loopStats.passes));
+    family("uptime_monitor_loop_duration_seconds", "counter", "Total time spent in the main loop body since boot.");
+    sample("uptime_monitor_loop_duration_seconds_total", "", String((double)loopStats.busyMicros / 1000000.0, 6));
+    family("uptime_monitor_loop_last_duration_seconds", "gauge", "Duration of the most recent main loop iteration.");
+    sample("uptime_monitor_loop_last_duration_seconds", "", String(loopStats.lastMicros / 1000000.0, 6));
+    family("uptime_monitor_loop_max_duration_seconds", "gauge", "Longest main loop iteration since boot.");
+    sample("uptime_monitor_loop_max_duration_seconds", "", String(loopStats.maxMicros / 1000000.0, 6));
+
+    family("uptime_monitor_task_busy_seconds", "counter", "Time each task spent working rather than waiting for work.");
+    for (int t = 0; t < TASK_SLOT_COUNT; t++) {
+      if (tasks[t].core < 0) continue;
+      sample("uptime_monitor_task_busy_seconds_total", taskLabels(tasks[t]),
+             String((double)tasks[t].busyMicros / 1000000.0, 6));
+    }
+    family("uptime_monitor_task_passes", "counter", "Wake-ups of each task since boot.");
+    for (int t = 0; t < TASK_SLOT_COUNT; t++) {
+      if (tasks[t].core < 0) continue;
+      sample("uptime_monitor_task_passes_total", taskLabels(tasks[t]), String(tasks[t].passes));
+    }
+    family("uptime_monitor_task_max_pass_seconds", "gauge", "Longest single pass of each task since boot.");
+    for (int t = 0; t < TASK_SLOT_COUNT; t++) {
+      if (tasks[t].core < 0) continue;
+      sample("uptime_monitor_task_max_pass_seconds", taskLabels(tasks[t]), String(tasks[t].maxMicros / 1000000.0, 6));
+    }
+    family("uptime_monitor_task_stack_free_bytes", "gauge", "Lowest free stack seen for each task.");
+    for (int t = 0; t < TASK_SLOT_COUNT; t++) {
+      if (tasks[t].core < 0) continue;
+      sample("uptime_monitor_task_stack_free_bytes", taskLabels(tasks[t]), String(tasks[t].stackFreeBytes));
+    }
+
+    family("uptime_monitor_uptime_seconds", "gauge", "Seconds since boot.");
+    sample("uptime_monitor_uptime_seconds", "", String(millis() / 1000));
+
+    pending += "# EOF\n";
+  }
+};
+
+void handleMetricsRequest(AsyncWebServerRequest *request) {
+  if (!admitRequest(request, REQ_METRICS)) {
+    return;
+  }
+  std::shared_ptr<MetricsStreamWriter> writer(new MetricsStreamWriter());
+  AsyncWebServerResponse *response = request->beginChunkedResponse(
+    "application/openmetrics-text; version=1.0.0; charset=utf-8",
+    [writer](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      return writer->fill(buffer, maxLen);
+    });
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+}
+
+// ---- Service Groups ----
+
+// Bucket a service is counted under; matches getServiceDisplayState(), with
+// paused services split by whether they were down so the LED can tell them apart
+AggregateState getAggregateState(const Service& service, unsigned long now) {
+  if (!service.enabled) return AGG_DISABLED;
+  if (getPauseRemainingMs(service.pauseUntil, now) > 0) {
+    return service.lastCheck > 0 && !service.isUp ? AGG_PAUSED_DOWN : AGG_PAUSED;
+  }
+  if (service.lastCheck == 0) return AGG_UNKNOWN;
+  return service.isUp ? AGG_UP : AGG_DOWN;
+}
+
+// Trimmed group name, cut to what GroupStatus can hold
+String normalizeServiceGroup(const String& group) {
+  String normalized = group;
+  normalized.trim();
+  if (normalized.length() > MAX_GROUP_NAME_LENGTH) {
+    normalized = normalized.substring(0, MAX_GROUP_NAME_LENGTH);
+    normalized.trim();
+  }
+  return normalized;
+}
+
+// Slot of a group in groupAggregates (names compare case-insensitively), or -1
+int findGroupSlot(const String& group) {
+  if (group.length() == 0) return -1;
+  for (int g = 0; g < groupAggregates.groupCount; g++) {
+    if (strcasecmp(groupAggregates.groups[g].name, group.c_str()) == 0) return g;
+  }
+  return -1;
+}
+
+// Recount every service and reassign group slots; called from rebuildServiceIndexes().
+// Groups past MAX_SERVICE_GROUPS (only reachable through import or a hand-edited
+// services.json) are counted in the totals only.
+void rebuildGroupAggregates() {
+  memset(&groupAggregates, 0, sizeof(groupAggregates));
+  unsigned long now = millis();
+
+  for (int i = 0; i < serviceCount; i++) {
+    Service& service = services[i];
+    int slot = findGroupSlot(service.group);
+    if (slot < 0 && service.group.length() > 0 && groupAggregates.groupCount < MAX_SERVICE_GROUPS) {
+      slot = groupAggregates.groupCount++;
+      strncpy(groupAggregates.groups[slot].name, service.group.c_str(), MAX_GROUP_NAME_LENGTH);
+    }
+    service.groupSlot = (int8_t)slot;
+    service.aggregateState = getAggregateState(service, now);
+    groupAggregates.totals.counts[service.aggregateState]++;
+    if (slot >= 0) {
+      groupAggregates.groups[slot].counts[service.aggregateState]++;
+    }
+  }
+}
+
+// Move a service to the bucket for its current state. Only entries of services[]
+// are counted; a Service being assembled for an add, edit or import is picked up
+// by the rebuild in saveServices(). Caller holds servicesMutex.
+void refreshServiceAggregate(Service& service) {
+  if (services == nullptr || &service < services || &service >= services + serviceCount ||
+      service.aggregateState >= AGG_STATE_COUNT) {
+    return;
+  }
+  uint8_t state = getAggregateState(service, millis());
+  if (state == service.aggregateState) {
+    return;
+  }
+  groupAggregates.totals.counts[service.aggregateState]--;
+  groupAggregates.totals.counts[state]++;
+  if (service.groupSlot >= 0) {
+    groupAggregates.groups[service.groupSlot].counts[service.aggregateState]--;
+    groupAggregates.groups[service.groupSlot].counts[state]++;
+  }
+  service.aggregateState = state;
+}
+
+int getGroupServiceTotal(const GroupStatus& group) {
+  int total = 0;
+  for (int s = 0; s < AGG_STATE_COUNT; s++) {
+    total += group.counts[s];
+  }
+  return total;
+}
+
+// Worst state in a group, using the getServiceDisplayState() names
+const char* getGroupStatusString(const GroupStatus& group) {
+  if (group.counts[AGG_DOWN] > 0) return "down";
+  if (group.counts[AGG_UNKNOWN] > 0) return "pending";
+  if (group.counts[AGG_UP] > 0) return "up";
+  if (group.counts[AGG_PAUSED] + group.counts[AGG_PAUSED_DOWN] > 0) return "paused";
+  return "disabled";
+}
+
+void addGroupStatusJson(JsonObject obj, const GroupStatus& group) {
+  obj["status"] = getGroupStatusString(group);
+  obj["total"] = getGroupServiceTotal(group);
+  obj["up"] = group.counts[AGG_UP];
+  obj["down"] = group.counts[AGG_DOWN];
+  obj["paused"] = group.counts[AGG_PAUSED] + group.counts[AGG_PAUSED_DOWN];
+  obj["pausedDown"] = group.counts[AGG_PAUSED_DOWN];
+  obj["pending"] = group.counts[AGG_UNKNOWN];
+  obj["disabled"] = group.counts[AGG_DISABLED];
+}
+
+// One-line group summary for notifications, e.g. "Group 'web': 2 of 5 services down."
+// Empty for ungrouped services. Caller holds servicesMutex.
+String describeServiceGroup(const Service& service) {
+  if (service.groupSlot < 0 || service.groupSlot >= groupAggregates.groupCount) {
+    return "";
+  }
+  const GroupStatus& group = groupAggregates.groups[service.groupSlot];
+  int down = group.counts[AGG_DOWN] + group.counts[AGG_PAUSED_DOWN];
+  int total = getGroupServiceTotal(group);
+  String summary = "Group '" + String(group.name) + "': ";
+  if (down == 0) {
+    summary += "none of " + String(total) + " services down.";
+  } else {
+    summary += String(down) + " of " + String(total) + " services down.";
+  }
+  return summary;
+}
+
+// ---- Static Status Page ----
+// /status is a server-rendered, script-free view of the services and their recent
+// uptime for wall displays and old browsers. loop() re-renders it only when
+// something it shows changes (service list, displayed state, or an hourly bucket)
+// and keeps just the gzipped bytes, so each view is one cached body or a 304.
+// Check timestamps are deliberately left out so routine passing checks don't
+// invalidate the cache.
+
+const unsigned long STATIC_PAGE_MIN_RENDER_INTERVAL_MS = 5000;  // Coalesce bursts (e.g. hour rollover)
+const int STATIC_PAGE_BAR_WIDTH = 3;                            // SVG units per hourly bucket
+
+struct StaticStatusPage {
+  StaticStatusPage() : gzip(PsramStdAllocator<uint8_t>(pageMemory)) {}
+  PsramBuffer gzip;
+  String etag;
+};
+
+// Published with std::atomic_store so the web task always sees a complete page
+std::shared_ptr<const StaticStatusPage> staticStatusPage;
+
+// Print adapter that appends to a byte vector
+class ByteBufferPrint : public Print {
+public:
+  explicit ByteBufferPrint(PsramBuffer& buffer) : buffer(buffer) {}
+
+  size_t write(uint8_t c) override {
+    buffer.push_back(c);
+    return 1;
+  }
+
+  size_t write(const uint8_t* data, size_t len) override {
+    buffer.insert(buffer.end(), data, data + len);
+    return len;
+  }
+
+private:
+  PsramBuffer& buffer;
+};
+
+static void printHtmlEscaped(Print& out, const String& text) {
+  for (size_t i = 0; i < text.length(); i++) {
+    char c = text[i];
+    switch (c) {
+      case '&': out.print("&amp;"); break;
+      case '<': out.print("&lt;"); break;
+      case '>': out.print("&gt;"); break;
+      case '"': out.print("&quot;"); break;
+      default: out.print(c); break;
+    }
+  }
+}
+
+void renderStaticStatusPage(Print& out) {
+  out.print(R"rawliteral(<!DOCTYPE html>
+<html lang="en">
+<head>
+<meta charset="UTF-8">
+<meta name="viewport" content="width=device-width, initial-scale=1.0">
+<meta http-equiv="refresh" content="60">
+<title>ESP32 Uptime Monitor</title>
+<style>
+body { margin: 0; padding: 20px; font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, sans-serif; background: linear-gradient(135deg, #667eea 0%, #764ba2 100%); min-height: 100vh; }
+.container { max-width: 900px; margin: 0 auto; }
+h1 { color: white; margin: 0 0 5px; }
+.summary { color: rgba(255,255,255,0.9); margin-bottom: 20px; }
+.summary a { color: white; }
+.service { background: white; border-radius: 10px; padding: 15px; margin-bottom: 12px; border-left: 6px solid #9ca3af; }
+.service.up { border-left-color: #10b981; }
+.service.down { border-left-color: #ef4444; }
+.service.paused { border-left-color: #f59e0b; }
+.service.pending { border-left-color: #6366f1; }
+.row { display: flex; justify-content: space-between; align-items: center; }
+.name { font-weight: 600; color: #1f2937; }
+.badge { padding: 3px 10px; border-radius: 12px; font-size: 0.8em; font-weight: 600; text-transform: uppercase; background: #f3f4f6; color: #4b5563; }
+.up .badge { background: #d1fae5; color: #065f46; }
+.down .badge { background: #fee2e2; color: #991b1b; }
+.paused .badge { background: #fef3c7; color: #92400e; }
+.pending .badge { background: #e0e7ff; color: #3730a3; }
+.meta { color: #6b7280; font-size: 0.85em; margin: 6px 0 8px; }
+.error { color: #991b1b; }
+svg { display: block; width: 100%; height: 24px; }
+.n { fill: #e5e7eb; }
+.u { fill: #10b981; }
+.w { fill: #f59e0b; }
+.d { fill: #ef4444; }
+</style>
+</head>
+<body>
+<div class="container">
+<h1>ESP32 Uptime Monitor</h1>
+)rawliteral");
+
+  unsigned long now = millis();
+  StatusSnapshotReader snapshot;
+
+  out.printf("<div class=\"summary\">%d of %d services up", snapshot->groups.totals.counts[AGG_UP], snapshot->count);
+  time_t wallClock = time(nullptr);
+  if (wallClock > 1700000000) {  // Only once NTP has set the clock
+    char timeStr[32];
+    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M", localtime(&wallClock));
+    out.printf(" &middot; last change %s", timeStr);
+  }
+  out.print(" &middot; <a href=\"/\">Full dashboard</a></div>\n");
+
+  const int barsWidth = DISPLAY_HISTORY_HOURS * STATIC_PAGE_BAR_WIDTH;
+  for (int i = 0; i < snapshot->count; i++) {
+    const ServiceStatus& service = snapshot->services[i];
+    const char* state = getServiceDisplayState(service, now);
+
+    out.printf("<div class=\"service %s\"><div class=\"row\"><span class=\"name\">", state);
+    printHtmlEscaped(out, service.info->name);
+    out.printf("</span><span class=\"badge\">%s</span></div>\n<div class=\"meta\">", state);
+    printHtmlEscaped(out, getServiceTypeString(service.info->type));
+
+    int historyIndex = getHistoryIndex(service.info->id);
+    const ServiceHistory* history = historyIndex >= 0 ? &serviceHistories[historyIndex] : nullptr;
+    int totalHours = history ? history->hourlyUptime.size() : 0;
+    if (totalHours > 0) {
+      unsigned long totalUptime = 0;
+      for (uint8_t uptime : history->hourlyUptime) {
+        totalUptime += uptime;
+      }
+      out.printf(" &middot; %.2f%% uptime", (float)totalUptime / (float)totalHours);
+    } else {
+      out.print(" &middot; no history yet");
+    }
+    if (strcmp(state, "down") == 0 && service.lastError[0] != '\0') {
+      out.print(" &middot; <span class=\"error\">");
+      printHtmlEscaped(out, service.lastError);
+      out.print("</span>");
+    }
+    out.print("</div>\n");
+
+    // One rect per run of same-colored hours, right-aligned so the newest hour is last;
+    // hours without data show the grey background
+    out.printf("<svg viewBox=\"0 0 %d 24\" preserveAspectRatio=\"none\"><rect class=\"n\" width=\"%d\" height=\"24\"/>",
+               barsWidth, barsWidth);
+    int windowHours = totalHours < DISPLAY_HISTORY_HOURS ? totalHours : DISPLAY_HISTORY_HOURS;
+    int firstIndex = totalHours - windowHours;
+    int x = (DISPLAY_HISTORY_HOURS - windowHours) * STATIC_PAGE_BAR_WIDTH;
+    int h = firstIndex;
+    while (h < totalHours) {
+      uint8_t uptime = history->hourlyUptime[h];
+      char barClass = uptime >= 99 ? 'u' : (uptime >= 90 ? 'w' : 'd');
+      int runStart = h;
+      do {
+        h++;
+      } while (h < totalHours &&
+               (history->hourlyUptime[h] >= 99 ? 'u' : (history->hourlyUptime[h] >= 90 ? 'w' : 'd')) == barClass);
+      int runWidth = (h - runStart) * STATIC_PAGE_BAR_WIDTH;
+      out.printf("<rect class=\"%c\" x=\"%d\" width=\"%d\" height=\"24\"/>", barClass, x, runWidth);
+      x += runWidth;
+    }
+    out.print("</svg></div>\n");
+  }
+
+  if (snapshot->count == 0) {
+    out.print("<div class=\"service\">No services configured</div>\n");
+  }
+  out.print("</div>\n</body>\n</html>\n");
+}
+
+// Called from loop(): re-render and compress the page when its inputs change.
+// Runs on the same task that records check results and finalizes hourly buckets.
+void refreshStaticStatusPage() {
+  static uint32_t seenStatusVersion = 0;
+  static uint32_t seenHistoryVersion = 0;
+  static uint32_t renderedKey = 0;
+  static unsigned long lastRender = 0;
+
+  unsigned long now = millis();
+  if (staticStatusPage && now - lastRender < STATIC_PAGE_MIN_RENDER_INTERVAL_MS) {
+    return;
+  }
+  // Under memory pressure keep serving the last render rather than building a new one
+  if (staticStatusPage && currentPressurePolicy().freezeStatusPage) {
+    return;
+  }
+
+  uint32_t historyVersionNow = historyVersion.load();
+  uint32_t statusVersionNow = statusVersion.load();
+  if (staticStatusPage && statusVersionNow == seenStatusVersion && historyVersionNow == seenHistoryVersion) {
+    return;
+  }
+  seenStatusVersion = statusVersionNow;
+  seenHistoryVersion = historyVersionNow;
+
+  // Most status changes are check results that leave the rendered fields alone;
+  // hash just those fields and skip the render if nothing visible moved
+  String keyMaterial = String(historyVersionNow);
+  {
+    StatusSnapshotReader snapshot;
+    for (int i = 0; i < snapshot->count; i++) {
+      const ServiceStatus& service = snapshot->services[i];
+      const char* state = getServiceDisplayState(service, now);
+      keyMaterial += '\x1e';
+      keyMaterial += service.info->id;
+      keyMaterial += '\x1f';
+      keyMaterial += service.info->name;
+      keyMaterial += '\x1f';
+      keyMaterial += state;
+      if (strcmp(state, "down") == 0) {
+        keyMaterial += '\x1f';
+        keyMaterial += service.lastError;
+      }
+    }
+  }
+  uint32_t key = fnv1aHash(keyMaterial.c_str(), keyMaterial.length());
+  if (staticStatusPage && key == renderedKey) {
+    return;
+  }
+
+  PsramBuffer html((PsramStdAllocator<uint8_t>(pageMemory)));
+  html.reserve(4096);
+  ByteBufferPrint out(html);
+  // Service state comes from the snapshot, but history buckets are read in place
+  // and the aggregator task appends to them
+  if (!xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
+    return;
+  }
+  renderStaticStatusPage(out);
+  xSemaphoreGive(servicesMutex);
+
+  std::shared_ptr<StaticStatusPage> page(new StaticStatusPage());
+  GzipEncoder::compress(html.data(), html.size(), page->gzip);
+  // Content hash rather than a counter so tags stay valid across reboots
+  page->etag = makeContentEtag('p', fnv1aHash((const char*)html.data(), html.size()));
+  std::atomic_store(&staticStatusPage, std::shared_ptr<const StaticStatusPage>(page));
+
+  renderedKey = key;
+  lastRender = now;
+  Serial.printf("Static status page rendered: %u bytes, %u gzipped\n",
+                (unsigned)html.size(), (unsigned)page->gzip.size());
+}
+
+void handleStaticStatusRequest(AsyncWebServerRequest *request) {
+  std::shared_ptr<const StaticStatusPage> page = std::atomic_load(&staticStatusPage);
+  bool acceptsGzip = request->hasHeader("Accept-Encoding") &&
+                     request->getHeader("Accept-Encoding")->value().indexOf("gzip") >= 0;
+
+  if (!page || !acceptsGzip) {
+    // Not rendered yet (first loop after boot) or a client without gzip: render live.
+    // This runs on the async_tcp task, so the lock wait is bounded (WEB_LOCK_TIMEOUT).
+    if (!xSemaphoreTake(servicesMutex, WEB_LOCK_TIMEOUT)) {
+      AsyncWebServerResponse* busy = request->beginResponse(503, "text/plain", "Status page busy, retry shortly");
+      busy->addHeader("Retry-After", "1");
+      request->send(busy);
+      return;
+    }
+    AsyncResponseStream* response = request->beginResponseStream("text/html");
+    response->addHeader("Cache-Control", "no-cache");
+    renderStaticStatusPage(*response);
+    xSemaphoreGive(servicesMutex);
+    request->send(response);
+    return;
+  }
+
+  if (sendNotModifiedIfMatch(request, page->etag)) {
+    return;
+  }
+
+  // The filler holds its own reference, so a re-render mid-send can't free the bytes
+  AsyncWebServerResponse* response = request->beginResponse(
+    "text/html", page->gzip.size(),
+    [page](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+      size_t remaining = page->gzip.size() - index;
+      size_t len = remaining < maxLen ? remaining : maxLen;
+      memcpy(buffer, page->gzip.data() + index, len);
+      return len;
+    });
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("Vary", "Accept-Encoding");
+  response->addHeader("ETag", page->etag);
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+}
+
+// ---- Push Ingestion ----
+
+// 32-bit FNV-1a hash
+uint32_t fnv1aHash(const char* data, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (uint8_t)data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Rebuild the id and push token -> services[] index tables, compile missing check
+// plans and recount group aggregates; caller holds servicesMutex (or runs in setup())
+// since positions shift when a service is deleted
+void rebuildServiceIndexes() {
+  serviceIdIndex.clear();
+  pushTokenIndex.clear();
+
+  for (int i = 0; i < serviceCount; i++) {
+    refreshServiceSchedule(i);
+    // Added, edited, imported and loaded services arrive here without a plan
+    if (!services[i].plan) {
+      services[i].plan = compileCheckPlan(services[i]);
+    }
+    serviceIdIndex.insert(fnv1aHash(services[i].id.c_str(), services[i].id.length()), i);
+    if (services[i].type != TYPE_PUSH || services[i].pushToken.length() == 0) {
+      continue;
+    }
+    pushTokenIndex.insert(fnv1aHash(services[i].pushToken.c_str(), services[i].pushToken.length()), i);
+  }
+
+  rebuildGroupAggregates();
+}
+
+// Look up a push service by token; returns its services[] index or -1
+int findPushServiceIndex(const String& token) {
+  return pushTokenIndex.find(fnv1aHash(token.c_str(), token.length()), [&](int index) {
+    return index < serviceCount && services[index].pushToken == token;
+  });
+}
+
+// Look up a service by id; returns its services[] index or -1. Caller holds servicesMutex.
+int findServiceIndex(const String& serviceId) {
+  return serviceIdIndex.find(fnv1aHash(serviceId.c_str(), serviceId.length()), [&](int index) {
+    return index < serviceCount && services[index].id == serviceId;
+  });
+}
+
+// Copy the scheduling fields of services[index] into its dense schedule entry
+void refreshServiceSchedule(int index) {
+  ServiceSchedule& entry = serviceSchedules[index];
+  entry.lastCheck = services[index].lastCheck;
+  entry.pauseUntil = services[index].pauseUntil;
+  entry.intervalMs = (uint32_t)services[index].checkInterval * 1000UL;
+  entry.enabled = services[index].enabled;
+}
+
+// Whether a schedule entry may be due; an expired pause counts so it gets cleared.
+// Intervals are stretched while memory pressure is critical.
+bool isScheduleDue(const ServiceSchedule& entry, unsigned long now) {
+  if (!entry.enabled) {
+    return false;
+  }
+  if (entry.pauseUntil > 0) {
+    return getPauseRemainingMs(entry.pauseUntil, now) == 0;
+  }
+  return now - entry.lastCheck >= entry.intervalMs * currentPressurePolicy().checkIntervalScale;
+}
+
+// Allocate count default-constructed entries, preferring PSRAM unless the table is
+// hot enough to belong in internal RAM. These tables live for the whole run, so
+// they are never freed.
+template <typename T>
+static T* allocateServiceTable(size_t count, bool preferPsram = true) {
+  void* memory = nullptr;
+  if (preferPsram && psramFound()) {
+    memory = heap_caps_malloc(sizeof(T) * count, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  }
+  if (memory == nullptr) {
+    memory = heap_caps_malloc(sizeof(T) * count, MALLOC_CAP_8BIT);
+  }
+  if (memory == nullptr) {
+    Serial.printf("FATAL: cannot allocate %u bytes for service storage\n", (unsigned)(sizeof(T) * count));
+    abort();
+  }
+  T* table = static_cast<T*>(memory);
+  for (size_t i = 0; i < count; i++) {
+    new (&table[i]) T();
+  }
+  return table;
+}
+
+// Size every per-service table from MAX_SERVICES; runs first thing in setup()
+void allocateServiceStorage() {
+  services = allocateServiceTable<Service>(MAX_SERVICES);
+  serviceSchedules = allocateServiceTable<ServiceSchedule>(MAX_SERVICES, false);
+  serviceHistories = allocateServiceTable<ServiceHistory>(MAX_SERVICES);
+  serviceEventLogs = allocateServiceTable<ServiceEventLog>(MAX_SERVICES);
+  notificationQueue = allocateServiceTable<QueuedNotification>(MAX_QUEUED_NOTIFICATIONS);
+  serviceJsonCache = allocateServiceTable<ServiceJsonCacheEntry>(MAX_SERVICES);
+  for (int i = 0; i < 2; i++) {
+    statusSnapshots[i].services = allocateServiceTable<ServiceStatus>(MAX_SERVICES);
+    statusSnapshots[i].count = 0;
+  }
+
+  serviceIdIndex.reset(MAX_SERVICES);
+  pushTokenIndex.reset(MAX_SERVICES);
+  historyIdIndex.reset(MAX_SERVICES);
+  eventLogIdIndex.reset(MAX_SERVICES);
+
+  Serial.printf("Service storage: %d slots, %u bytes per service (%s)\n", MAX_SERVICES,
+                (unsigned)(sizeof(Service) + 2 * sizeof(ServiceStatus) + sizeof(ServiceSchedule) +
+                           sizeof(ServiceHistory) + sizeof(ServiceEventLog)),
+                psramFound() ? "PSRAM" : "internal RAM");
+}
 
-    if (needsCheck) {
-#ifdef HAS_LCD
-      anyServiceChecked = true;
-#endif
-      // Perform the actual check on the copy
-      bool checkResult = false;
-      Serial.printf("[CHECK] %s (%s) - ", serviceCopy.name.c_str(), getServiceTypeString(serviceCopy.type).c_str());
-      
-      switch (serviceCopy.type) {
-        case TYPE_HTTP_GET:
-          checkResult = checkHttpGet(serviceCopy);
-          break;
-        case TYPE_PING:
-          checkResult = checkPing(serviceCopy);
-          break;
-        case TYPE_SNMP_GET:
-          checkResult = checkSnmpGet(serviceCopy);
-          break;
-        case TYPE_PORT:
-          checkResult = checkPort(serviceCopy);
-          break;
-        case TYPE_PUSH:
-          checkResult = checkPush(serviceCopy);
-          break;
-        case TYPE_UPTIME:
-          checkResult = checkUptime(serviceCopy);
-          break;
-      }
-      
-      if (checkResult) {
-        Serial.println("✓ PASS");
-      } else {
-        Serial.printf("✗ FAIL: %s\n", serviceCopy.lastError.c_str());
-      }
+// Add one sample to a latency histogram
+void recordLatency(LatencyHistogram& histogram, uint32_t durationMs) {
+  int bucket = 0;
+  while (bucket < LATENCY_BUCKET_COUNT - 1 && durationMs > LATENCY_BUCKET_BOUNDS_MS[bucket]) {
+    bucket++;
+  }
+  histogram.buckets[bucket]++;
+  histogram.count++;
+  histogram.sumMs += durationMs;
+  histogram.lastMs = durationMs;
+}
 
-      // Update original service
-      if (xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
-        // Find service by ID in case index shifted
-        int idx = -1;
-        for (int k = 0; k < serviceCount; k++) {
-          if (services[k].id == serviceCopy.id) {
-            idx = k;
-            break;
-          }
-        }
+// Clear latency, pushed value, push outcome and check counters (new, imported or loaded services)
+void resetServiceTelemetry(Service& service) {
+  service.latency = LatencyHistogram();
+  service.lastValue = 0;
+  service.hasValue = false;
+  service.lastPushFailed = false;
+  service.lastPushMessage = "";
+  service.lastErrorCode = CHECK_OK;
+  service.checksTotal = 0;
+  service.checksFailed = 0;
+  memset(service.errorCounts, 0, sizeof(service.errorCounts));
+}
 
-        if (idx != -1) {
-          // Record check result in history (needs mutex as it accesses serviceHistories)
-          recordCheckResult(services[idx].id, checkResult);
+// Apply queued pushes to the service state machine (aggregator task only).
+// Takes servicesMutex once per batch; recovery notifications go through
+// alertQueue so a slow notifier doesn't stall checks or the web UI.
+void processPushQueue() {
+  const int PUSH_BATCH_SIZE = 8;
+  PushEvent batch[PUSH_BATCH_SIZE];
 
-          bool wasUp = services[idx].isUp;
+  while (true) {
+    int batchCount = 0;
+    while (batchCount < PUSH_BATCH_SIZE && pushQueue.tryPop(batch[batchCount])) {
+      batchCount++;
+    }
+    if (batchCount == 0) {
+      return;
+    }
 
-          if (checkResult) {
-            services[idx].consecutivePasses++;
-            services[idx].consecutiveFails = 0;
-            services[idx].lastUptime = currentTime;
-            services[idx].lastError = "";
-            services[idx].failedChecksSinceAlert = 0;  // Reset re-arm counter on success
-          } else {
-            services[idx].consecutiveFails++;
-            services[idx].consecutivePasses = 0;
-            services[idx].lastError = serviceCopy.lastError; // Copy error from check
+    if (xSemaphoreTake(servicesMutex, portMAX_DELAY)) {
+      for (int b = 0; b < batchCount; b++) {
+        int idx = batch[b].serviceIndex;
+        if (idx < 0 || idx >= serviceCount || services[idx].type != TYPE_PUSH ||
+            fnv1aHash(services[idx].pushToken.c_str(), services[idx].pushToken.length()) != batch[b].tokenHash) {
+          continue;  // Service was edited or deleted after the push was accepted
+        }
+
+        Service& service = services[idx];
+        const PushEvent& event = batch[b];
+        unsigned long now = event.receivedAt;
+        service.lastPush = now;
+        service.lastPushMessage = event.message;
+
+        if (event.hasDuration) {
+          recordLatency(service.latency, event.durationMs);
+        }
+
+        String failure;
+        CheckError failureCode = CHECK_OK;
+        if (event.reportedDown) {
+          failure = event.message[0] != '\0' ? String(event.message) : String("Push reported down");
+          failureCode = CHECK_ERR_PUSH_DOWN;
+        }
+        if (event.hasValue) {
+          service.lastValue = event.value;
+          service.hasValue = true;
+          if (failure.length() == 0 && service.config.length(CFG_SNMP_EXPECTED_VALUE) > 0 &&
+              !compareSnmpValue(String(event.valueText), service.snmpCompareOp, service.config.get(CFG_SNMP_EXPECTED_VALUE))) {
+            failureCode = CHECK_ERR_MISMATCH;
+            failure = "Value mismatch: got '" + String(event.valueText) + "', expected " +
+                      getSnmpCompareOpString(service.snmpCompareOp) + " '" +
+                      service.config.get(CFG_SNMP_EXPECTED_VALUE) + "'";
           }
+        }
 
-          // Determine new state based on thresholds
-          if (!services[idx].isUp && services[idx].consecutivePasses >= services[idx].passThreshold) {
-            // Service has passed enough times to be considered UP
-            services[idx].isUp = true;
-            services[idx].failedChecksSinceAlert = 0;  // Reset re-arm counter on recovery
-          } else if (services[idx].isUp && services[idx].consecutiveFails >= services[idx].failThreshold) {
-            // Service has failed enough times to be considered DOWN
-            services[idx].isUp = false;
-          }
+        // A failing push is a fresh heartbeat with a bad result: checkPush() reports
+        // it on each scheduled check so failThreshold/re-arm apply as for active checks
+        service.lastPushFailed = failure.length() > 0;
+        if (service.lastPushFailed) {
+          service.lastError = failure;
+          service.lastErrorCode = failureCode;
+          markServiceChanged(service);
+          publishServiceCheck(service);
+          Serial.printf("Push for service '%s' reported failure: %s\n", service.name.c_str(), failure.c_str());
+          continue;
+        }
 
-          // Log and notify on state changes
-          if (wasUp != services[idx].isUp) {
-            Serial.printf("Service '%s' is now %s (after %d consecutive %s)\n",
-              services[idx].name.c_str(),
-              services[idx].isUp ? "UP" : "DOWN",
-              services[idx].isUp ? services[idx].consecutivePasses : services[idx].consecutiveFails,
-              services[idx].isUp ? "passes" : "fails");
+        bool wasUp = service.isUp;
 
-            // Record the state change event
-            String reason = services[idx].isUp ? 
-              String(services[idx].consecutivePasses) + " consecutive passes" :
-              String(services[idx].consecutiveFails) + " consecutive fails";
-            recordServiceEvent(services[idx].id, services[idx].isUp, reason);
+        // Mark the service as passing immediately
+        service.lastCheck = now;
+        service.lastUptime = now;
+        service.secondsSinceLastCheck = 0;
+        service.consecutiveFails = 0;
+        service.failedChecksSinceAlert = 0;
+        service.lastError = "";
+        service.lastErrorCode = CHECK_OK;
 
-#ifdef HAS_LCD
-            // Set display update flag BEFORE notifications to ensure display refreshes
-            displayNeedsUpdate = true;
-#endif
+        int requiredPasses = service.passThreshold >= 1 ? service.passThreshold : 1;
+        service.consecutivePasses = requiredPasses;
+        service.isUp = true;
+        markServiceChanged(service);
+        publishServiceCheck(service);
 
-            if (!services[idx].isUp) {
-              sendOfflineNotification(services[idx]);
-              services[idx].failedChecksSinceAlert = 0;  // Reset counter after initial alert
-            } else if (services[idx].hasBeenUp) {
-              // Only send online notification if service was previously UP (not initial UP after boot)
-              sendOnlineNotification(services[idx]);
-            }
-            
-            // Mark that service has been UP at least once (for initial UP notification suppression)
-            if (services[idx].isUp) {
-              services[idx].hasBeenUp = true;
-            }
-          } else if (!services[idx].isUp && !checkResult && services[idx].rearmCount > 0) {
-            // Service is still DOWN and check failed - handle re-arm logic
-            services[idx].failedChecksSinceAlert++;
-            if (services[idx].failedChecksSinceAlert >= services[idx].rearmCount) {
-              Serial.printf("Service '%s' still DOWN - re-arming alert after %d failed checks\n",
-                services[idx].name.c_str(), services[idx].failedChecksSinceAlert);
-              sendOfflineNotification(services[idx]);
-              services[idx].failedChecksSinceAlert = 0;  // Reset counter after re-arm alert
-            }
-          }
+        if (!wasUp) {
+          Serial.printf("Push service '%s' marked UP immediately\n", service.name.c_str());
 
 #ifdef HAS_LCD
-          // Update display if viewing detail view and this specific service was checked
-          if (currentView == VIEW_DETAIL && idx == currentServiceIndex) {
-            displayNeedsUpdate = true;
-          }
+          displayNeedsUpdate = true;
 #endif
+
+          if (service.hasBeenUp) {
+            queueAlert(idx, true);
+          }
+          service.hasBeenUp = true;
         }
-        xSemaphoreGive(servicesMutex);
+        Serial.printf("Push received for service '%s'\n", service.name.c_str());
       }
+      publishStatusSnapshot();
+      xSemaphoreGive(servicesMutex);
     }
-    i++;
   }
-
-#ifdef HAS_LCD
-  // Update display if in main view and any service was checked
-  // This is done once outside the loop to avoid redundant flag setting
-  if (currentView == VIEW_MAIN && anyServiceChecked) {
-    displayNeedsUpdate = true;
-  }
-#endif
 }
 
-// Helper function to match text against a POSIX extended regex pattern
-// Returns 0 on match, 1 on no match, -1 on pattern too long, -2 on invalid pattern
-int matchesRegex(const String& text, const String& pattern) {
-  // Limit pattern length to prevent excessive resource usage
-  if (pattern.length() > MAX_REGEX_PATTERN_LENGTH) {
-    return -1;
-  }
-  
-  regex_t regex;
-  int result;
-  
-  // Compile the regex pattern with extended syntax
-  result = regcomp(&regex, pattern.c_str(), REG_EXTENDED | REG_NOSUB);
-  if (result != 0) {
-    // Pattern compilation failed - do not call regfree() on failed compile
-    return -2;
+// ---- Check Plans ----
+
+// Parse a service's check config into a new immutable plan. Called from
+// rebuildServiceIndexes() for services whose plan was cleared by a save, so the
+// regex compile and number parsing happen once per edit instead of once per check.
+CheckPlanRef compileCheckPlan(const Service& service) {
+  std::shared_ptr<CheckPlan> plan = std::make_shared<CheckPlan>();
+  plan->serviceId = service.id;
+  plan->serviceName = service.name;
+  plan->type = service.type;
+  plan->config = service.config;
+  plan->port = service.port;
+  plan->snmpCompareOp = service.snmpCompareOp;
+  plan->uptimeThreshold = service.uptimeThreshold;
+  plan->uptimeCompareOp = service.uptimeCompareOp;
+
+  const char* host = plan->config.get(CFG_HOST);
+  plan->hostIsAddress = host[0] != '\0' && plan->hostAddress.fromString(host);
+
+  plan->expectedIsNumeric = parseSnmpNumber(plan->config.get(CFG_SNMP_EXPECTED_VALUE), plan->expectedNumber);
+
+  if (service.type == TYPE_HTTP_GET) {
+    const char* url = plan->config.get(CFG_URL);
+    plan->isSecure = strncmp(url, "https://", 8) == 0;
+    if (url[0] == '\0') {
+      plan->configError = CHECK_ERR_CONFIG;
+      plan->configErrorText = "URL not configured";
+    }
+
+    const char* expected = plan->config.get(CFG_EXPECTED_RESPONSE);
+    if (strcmp(expected, "*") == 0) {
+      plan->matchMode = MATCH_ANY;
+    } else if (strncmp(expected, REGEX_PREFIX, REGEX_PREFIX_LENGTH) == 0) {
+      plan->matchMode = MATCH_REGEX;
+      const char* pattern = expected + REGEX_PREFIX_LENGTH;
+      // Limit pattern length to prevent excessive resource usage
+      if (strlen(pattern) > MAX_REGEX_PATTERN_LENGTH) {
+        plan->configError = CHECK_ERR_CONFIG;
+        plan->configErrorText = "Regex pattern too long";
+      } else if (regcomp(&plan->regex, pattern, REG_EXTENDED | REG_NOSUB) == 0) {
+        plan->regexCompiled = true;
+      } else {
+        // Do not call regfree() on a failed compile; regexCompiled stays false
+        plan->configError = CHECK_ERR_CONFIG;
+        plan->configErrorText = "Invalid regex pattern";
+      }
+    } else {
+      plan->matchMode = MATCH_SUBSTRING;
+    }
   }
-  
-  // Execute the regex match
-  result = regexec(&regex, text.c_str(), 0, NULL, 0);
-  regfree(&regex);
-  
-  return result == 0 ? 0 : 1;  // 0 = match, 1 = no match
+
+  return plan;
 }
 
-bool checkHttpGet(Service& service) {
-  HTTPClient http;
-  
-  // Use the URL field directly - supports both HTTP and HTTPS
-  String url = service.url;
-  
-  // Handle empty URL
-  if (url.length() == 0) {
-    service.lastError = "URL not configured";
+bool checkHttpGet(const CheckPlan& plan, CheckOutcome& outcome) {
+  // Missing URL or a bad regex can't pass; report it without touching the network
+  if (plan.configError != CHECK_OK) {
+    outcome.code = plan.configError;
+    outcome.error = plan.configErrorText;
     return false;
   }
-  
+
+  HTTPClient http;
+
   // Handle HTTPS URLs by using WiFiClientSecure
-  bool isSecure = url.startsWith("https://");
   WiFiClient* client = nullptr;
   WiFiClient plainClient;
   WiFiClientSecure secureClient;
 
-  if (isSecure) {
+  if (plan.isSecure) {
     secureClient.setInsecure();  // Skip certificate validation for HTTPS targets
     client = &secureClient;
   } else {
@@ -3110,8 +6490,9 @@ bool checkHttpGet(Service& service) {
   }
 
   // Ensure the underlying client stays in scope for the full request lifecycle
-  if (!http.begin(*client, url)) {
-    service.lastError = "Invalid URL";
+  if (!http.begin(*client, plan.config.get(CFG_URL))) {
+    outcome.code = CHECK_ERR_CONFIG;
+    outcome.error = "Invalid URL";
     return false;
   }
 
@@ -3122,68 +6503,76 @@ bool checkHttpGet(Service& service) {
 
   if (httpCode > 0) {
     if (httpCode == 200) {
-      if (service.expectedResponse == "*") {
+      if (plan.matchMode == MATCH_ANY) {
         isUp = true;
       } else {
         String payload = http.getString();
-        // Check if expectedResponse is a regex pattern (prefixed with "regex:")
-        if (service.expectedResponse.startsWith(REGEX_PREFIX)) {
-          String pattern = service.expectedResponse.substring(REGEX_PREFIX_LENGTH);
-          int regexResult = matchesRegex(payload, pattern);
-          if (regexResult == 0) {
-            isUp = true;
-          } else if (regexResult == -1) {
-            service.lastError = "Regex pattern too long";
-          } else if (regexResult == -2) {
-            service.lastError = "Invalid regex pattern";
-          } else {
-            service.lastError = "Regex mismatch";
+        if (plan.matchMode == MATCH_REGEX) {
+          isUp = regexec(&plan.regex, payload.c_str(), 0, NULL, 0) == 0;
+          if (!isUp) {
+            outcome.code = CHECK_ERR_MISMATCH;
+            outcome.error = "Regex mismatch";
           }
         } else {
           // Plain substring match
-          isUp = payload.indexOf(service.expectedResponse) >= 0;
+          isUp = strstr(payload.c_str(), plan.config.get(CFG_EXPECTED_RESPONSE)) != nullptr;
           if (!isUp) {
-            service.lastError = "Response mismatch";
+            outcome.code = CHECK_ERR_MISMATCH;
+            outcome.error = "Response mismatch";
           }
         }
       }
     } else {
-      service.lastError = "HTTP " + String(httpCode);
+      outcome.code = CHECK_ERR_HTTP_STATUS;
+      outcome.error = "HTTP " + String(httpCode);
     }
   } else {
-    service.lastError = "Connection failed: " + String(httpCode);
+    outcome.code = CHECK_ERR_CONNECT;
+    outcome.error = "Connection failed: " + String(httpCode);
   }
 
   http.end();
   return isUp;
 }
 
-bool checkPing(Service& service) {
-  bool success = Ping.ping(service.host.c_str(), 3);
+#if CHECK_TYPE_PING
+bool checkPing(const CheckPlan& plan, CheckOutcome& outcome) {
+  bool success = plan.hostIsAddress ? Ping.ping(plan.hostAddress, 3) : Ping.ping(plan.config.get(CFG_HOST), 3);
   if (!success) {
-    service.lastError = "Ping timeout";
+    outcome.code = CHECK_ERR_TIMEOUT;
+    outcome.error = "Ping timeout";
   }
   return success;
 }
+#endif
 
-bool checkPort(Service& service) {
+#if CHECK_TYPE_PORT
+bool checkPort(const CheckPlan& plan, CheckOutcome& outcome) {
   WiFiClient client;
   // Attempt TCP connection with configured timeout
-  if (client.connect(service.host.c_str(), service.port, PORT_CHECK_TIMEOUT_MS)) {
+  bool connected = plan.hostIsAddress
+    ? client.connect(plan.hostAddress, plan.port, PORT_CHECK_TIMEOUT_MS)
+    : client.connect(plan.config.get(CFG_HOST), plan.port, PORT_CHECK_TIMEOUT_MS);
+  if (connected) {
     client.stop();
     return true;
   }
-  service.lastError = "Port closed or unreachable";
+  outcome.code = CHECK_ERR_CONNECT;
+  outcome.error = "Port closed or unreachable";
   return false;
 }
+#endif
 
-bool checkPush(Service& service) {
+// Judges the live push state, so unlike the other checks it reads services[]
+// directly; caller holds servicesMutex
+bool checkPush(const Service& service, CheckOutcome& outcome) {
   // For push-based services, check if a push was received within the check interval
   unsigned long currentTime = millis();
   
   // If no push has ever been received, treat as not up yet
   if (service.lastPush == 0) {
-    service.lastError = "No push received yet";
+    outcome.code = CHECK_ERR_NO_PUSH;
+    outcome.error = "No push received yet";
     return false;
   }
   
@@ -3193,21 +6582,29 @@ bool checkPush(Service& service) {
   unsigned long intervalMs = (unsigned long)service.checkInterval * 1000UL;
   
   if (pushAge <= intervalMs + PUSH_TIMING_MARGIN_MS) {
+    if (service.lastPushFailed) {
+      // Keep the failure recorded by processPushQueue()
+      outcome.code = service.lastErrorCode;
+      outcome.error = service.lastError;
+      return false;
+    }
     return true;
   }
   
-  service.lastError = "No push received within interval";
+  outcome.code = CHECK_ERR_NO_PUSH;
+  outcome.error = "No push received within interval";
   return false;
 }
 
-bool checkUptime(Service& service) {
+#if CHECK_TYPE_UPTIME
+bool checkUptime(const CheckPlan& plan, CheckOutcome& outcome) {
   // Get current uptime in seconds
   unsigned long uptimeSeconds = millis() / 1000;
-  int threshold = service.uptimeThreshold;
+  int threshold = plan.uptimeThreshold;
   
   // Perform comparison based on operator
   bool result = false;
-  switch (service.uptimeCompareOp) {
+  switch (plan.uptimeCompareOp) {
     case SNMP_OP_EQ:
       result = (uptimeSeconds == threshold);
       break;
@@ -3227,45 +6624,42 @@ bool checkUptime(Service& service) {
       result = (uptimeSeconds <= threshold);
       break;
     default:
-      service.lastError = "Invalid comparison operator";
+      outcome.code = CHECK_ERR_CONFIG;
+      outcome.error = "Invalid comparison operator";
       return false;
   }
   
   // Always store the uptime value in lastError so UI can display it
-  service.lastError = "Uptime " + String(uptimeSeconds) + "s";
+  outcome.code = CHECK_ERR_MISMATCH;
+  outcome.error = "Uptime " + String(uptimeSeconds) + "s";
   
   return result;
 }
+#endif
+
+// Parse an SNMP/push value as a number; false when text is empty or not entirely numeric
+bool parseSnmpNumber(const char* text, float& value) {
+  if (text[0] == '\0') {
+    return false;
+  }
+  char* endPtr;
+  value = strtof(text, &endPtr);
+  return *endPtr == '\0';
+}
 
 // Helper function to compare SNMP values based on operator
 bool compareSnmpValue(const String& actualValue, SnmpCompareOp op, const String& expectedValue) {
+  float expectedNum = 0;
+  bool expectedIsNumeric = parseSnmpNumber(expectedValue.c_str(), expectedNum);
+  return compareSnmpValue(actualValue, op, expectedValue.c_str(), expectedIsNumeric, expectedNum);
+}
+
+// Same, with the expected value already parsed (see CheckPlan)
+bool compareSnmpValue(const String& actualValue, SnmpCompareOp op, const char* expectedValue,
+                      bool expectedIsNumeric, float expectedNum) {
   // Try numeric comparison first
-  bool actualIsNumeric = true;
-  bool expectedIsNumeric = true;
   float actualNum = 0;
-  float expectedNum = 0;
-  
-  // Check if actual value is numeric
-  if (actualValue.length() > 0) {
-    char* endPtr;
-    actualNum = strtof(actualValue.c_str(), &endPtr);
-    if (*endPtr != '\0') {
-      actualIsNumeric = false;
-    }
-  } else {
-    actualIsNumeric = false;
-  }
-  
-  // Check if expected value is numeric
-  if (expectedValue.length() > 0) {
-    char* endPtr;
-    expectedNum = strtof(expectedValue.c_str(), &endPtr);
-    if (*endPtr != '\0') {
-      expectedIsNumeric = false;
-    }
-  } else {
-    expectedIsNumeric = false;
-  }
+  bool actualIsNumeric = parseSnmpNumber(actualValue.c_str(), actualNum);
   
   // Use numeric comparison if both are numeric
   if (actualIsNumeric && expectedIsNumeric) {
@@ -3280,7 +6674,7 @@ bool compareSnmpValue(const String& actualValue, SnmpCompareOp op, const String&
   }
   
   // Fall back to string comparison for non-numeric values
-  int cmp = actualValue.compareTo(expectedValue);
+  int cmp = strcmp(actualValue.c_str(), expectedValue);
   switch (op) {
     case SNMP_OP_EQ: return cmp == 0;
     case SNMP_OP_NE: return cmp != 0;
@@ -3293,6 +6687,7 @@ bool compareSnmpValue(const String& actualValue, SnmpCompareOp op, const String&
   return false;
 }
 
+#if CHECK_TYPE_SNMP
 // Global variables for SNMP response handling (static to persist across calls)
 static bool s_snmpGotResponse = false;
 static String s_snmpResponseValue = "";
@@ -3346,16 +6741,13 @@ void onSnmpMessage(const SNMP::Message *message, const IPAddress remote, const u
   }
 }
 
-bool checkSnmpGet(Service& service) {
+bool checkSnmpGet(const CheckPlan& plan, CheckOutcome& outcome) {
   // Using patricklaf/SNMP library with Manager class and callback pattern
-  String hostStr = service.host;
-  String communityStr = service.snmpCommunity;
-  String oidStr = service.snmpOid;
-
-  // Resolve hostname to IP
-  IPAddress targetIP;
-  if (!WiFi.hostByName(hostStr.c_str(), targetIP)) {
-    service.lastError = "DNS resolution failed";
+  // Resolve hostname to IP unless the plan already holds an address
+  IPAddress targetIP = plan.hostAddress;
+  if (!plan.hostIsAddress && !WiFi.hostByName(plan.config.get(CFG_HOST), targetIP)) {
+    outcome.code = CHECK_ERR_DNS;
+    outcome.error = "DNS resolution failed";
     return false;
   }
   
@@ -3369,18 +6761,20 @@ bool checkSnmpGet(Service& service) {
   snmp.onMessage(onSnmpMessage);  // Set callback handler
   
   if (!snmp.begin(udp)) {
-    service.lastError = "Failed to initialize SNMP manager";
+    outcome.code = CHECK_ERR_INTERNAL;
+    outcome.error = "Failed to initialize SNMP manager";
     return false;
   }
   
   // Create SNMP GetRequest message
-  SNMP::Message *request = new SNMP::Message(SNMP::Version::V2C, communityStr.c_str(), SNMP::Type::GetRequest);
-  request->add(oidStr.c_str(), new SNMP::NullBER());  // In GetRequest, values are always NULL
+  SNMP::Message *request = new SNMP::Message(SNMP::Version::V2C, plan.config.get(CFG_SNMP_COMMUNITY), SNMP::Type::GetRequest);
+  request->add(plan.config.get(CFG_SNMP_OID), new SNMP::NullBER());  // In GetRequest, values are always NULL
   
   // Send the request
   if (!snmp.send(request, targetIP, 161)) {  // SNMP port 161
     delete request;
-    service.lastError = "Failed to send SNMP request";
+    outcome.code = CHECK_ERR_CONNECT;
+    outcome.error = "Failed to send SNMP request";
     return false;
   }
   
@@ -3397,21 +6791,25 @@ bool checkSnmpGet(Service& service) {
   }
   
   if (!s_snmpGotResponse) {
-    service.lastError = "SNMP timeout or no valid response";
+    outcome.code = CHECK_ERR_TIMEOUT;
+    outcome.error = "SNMP timeout or no valid response";
     return false;
   }
   
   // Compare the received value with expected value
-  bool success = compareSnmpValue(s_snmpResponseValue, service.snmpCompareOp, service.snmpExpectedValue);
+  bool success = compareSnmpValue(s_snmpResponseValue, plan.snmpCompareOp, plan.config.get(CFG_SNMP_EXPECTED_VALUE),
+                                  plan.expectedIsNumeric, plan.expectedNumber);
   
   if (!success) {
-    service.lastError = "Value mismatch: got '" + s_snmpResponseValue + "', expected " + 
-                        getSnmpCompareOpString(service.snmpCompareOp) + " '" + 
-                        service.snmpExpectedValue + "'";
+    outcome.code = CHECK_ERR_MISMATCH;
+    outcome.error = "Value mismatch: got '" + s_snmpResponseValue + "', expected " + 
+                    getSnmpCompareOpString(plan.snmpCompareOp) + " '" + 
+                    plan.config.get(CFG_SNMP_EXPECTED_VALUE) + "'";
   }
   
   return success;
 }
+#endif
 
 String getSnmpCompareOpString(SnmpCompareOp op) {
   switch (op) {
@@ -3435,7 +6833,7 @@ SnmpCompareOp parseSnmpCompareOp(const String& opStr) {
   return SNMP_OP_EQ;  // Default to equal
 }
 
-void sendOfflineNotification(const Service& service) {
+void sendOfflineNotification(const Service& service, const String& groupSummary) {
   if (!isNtfyConfigured() && !isDiscordConfigured() && !isSmtpConfigured() && !isMeshCoreConfigured()) {
     return;
   }
@@ -3443,8 +6841,8 @@ void sendOfflineNotification(const Service& service) {
   bool wifiConnected = WiFi.status() == WL_CONNECTED;
 
   String title = "Service DOWN: " + service.name;
-  String message = "Service '" + service.name + "' at " + service.host;
-  if (service.port > 0 && service.type != TYPE_PING) {
+  String message = "Service '" + service.name + "' at " + service.config.get(CFG_HOST);
+  if (service.port > 0 && (CheckTypes::flags(service.type) & CHECK_USES_PORT)) {
     message += ":" + String(service.port);
   }
   message += " is offline.";
@@ -3452,6 +6850,9 @@ void sendOfflineNotification(const Service& service) {
   if (service.lastError.length() > 0) {
     message += " Error: " + service.lastError;
   }
+  if (groupSummary.length() > 0) {
+    message += " " + groupSummary;
+  }
 
   String tags = "warning,monitor";
   bool ntfyFailed = false;
@@ -3495,7 +6896,7 @@ void sendOfflineNotification(const Service& service) {
                     ntfyFailed, discordFailed, smtpFailed, meshFailed);
 }
 
-void sendOnlineNotification(const Service& service) {
+void sendOnlineNotification(const Service& service, const String& groupSummary) {
   if (!isNtfyConfigured() && !isDiscordConfigured() && !isSmtpConfigured() && !isMeshCoreConfigured()) {
     return;
   }
@@ -3503,11 +6904,14 @@ void sendOnlineNotification(const Service& service) {
   bool wifiConnected = WiFi.status() == WL_CONNECTED;
 
   String title = "Service UP: " + service.name;
-  String message = "Service '" + service.name + "' at " + service.host;
-  if (service.port > 0 && service.type != TYPE_PING) {
+  String message = "Service '" + service.name + "' at " + service.config.get(CFG_HOST);
+  if (service.port > 0 && (CheckTypes::flags(service.type) & CHECK_USES_PORT)) {
     message += ":" + String(service.port);
   }
   message += " is back online.";
+  if (groupSummary.length() > 0) {
+    message += " " + groupSummary;
+  }
 
   String tags = "ok,monitor";
   bool ntfyFailed = false;
@@ -3515,7 +6919,11 @@ void sendOnlineNotification(const Service& service) {
   bool smtpFailed = false;
   bool meshFailed = false;
 
-  if (wifiConnected) {
+  // A recovery can wait; under memory pressure don't open TLS connections for it
+  // and let the retry queue send it once the heap recovers
+  bool deferred = currentPressurePolicy().deferRecoveryAlerts;
+
+  if (wifiConnected && !deferred) {
     if (isNtfyConfigured()) {
       if (!sendNtfyNotificationWithStatus(title, message, tags)) {
         ntfyFailed = true;
@@ -3534,7 +6942,8 @@ void sendOnlineNotification(const Service& service) {
       }
     }
   } else {
-    Serial.println("WiFi offline: queueing internet notifications");
+    Serial.println(deferred ? "Memory pressure: deferring recovery notifications"
+                            : "WiFi offline: queueing internet notifications");
     ntfyFailed = isNtfyConfigured();
     discordFailed = isDiscordConfigured();
     smtpFailed = isSmtpConfigured();
@@ -3551,6 +6960,7 @@ void sendOnlineNotification(const Service& service) {
                     ntfyFailed, discordFailed, smtpFailed, meshFailed);
 }
 
+#if FEATURE_NTFY
 void sendNtfyNotification(const String& title, const String& message, const String& tags) {
   HTTPClient http;
   String url = String(NTFY_SERVER) + "/" + NTFY_TOPIC;
@@ -3583,7 +6993,11 @@ void sendNtfyNotification(const String& title, const String& message, const Stri
 
   http.end();
 }
+#else
+void sendNtfyNotification(const String& title, const String& message, const String& tags) {}
+#endif  // FEATURE_NTFY
 
+#if FEATURE_DISCORD
 void sendDiscordNotification(const String& title, const String& message) {
   HTTPClient http;
   String url = String(DISCORD_WEBHOOK_URL);
@@ -3599,7 +7013,7 @@ void sendDiscordNotification(const String& title, const String& message) {
 
   http.addHeader("Content-Type", "application/json");
 
-  JsonDocument doc;
+  JsonDocument doc(&notifyMemory);
   doc["content"] = "**" + title + "**\n" + message;
 
   String payload;
@@ -3615,6 +7029,9 @@ void sendDiscordNotification(const String& title, const String& message) {
 
   http.end();
 }
+#else
+void sendDiscordNotification(const String& title, const String& message) {}
+#endif  // FEATURE_DISCORD
 
 void sendMeshCoreNotification(const String& title, const String& message) {
 #ifdef HAS_LORA_RADIO
@@ -3716,6 +7133,7 @@ void sendMeshCoreNotification(const String& title, const String& message) {
 #endif
 }
 
+#if FEATURE_SMTP
 String base64Encode(const String& input) {
   size_t outputLength = 0;
   size_t bufferLength = ((input.length() + 2) / 3) * 4 + 4;
@@ -3827,6 +7245,9 @@ void sendSmtpNotification(const String& title, const String& message) {
 
   Serial.println("SMTP notification sent");
 }
+#else
+void sendSmtpNotification(const String& title, const String& message) {}
+#endif  // FEATURE_SMTP
 
 void sendBootNotification() {
   if (!isNtfyConfigured() && !isDiscordConfigured() && !isSmtpConfigured() && !isMeshCoreConfigured()) {
@@ -3871,6 +7292,7 @@ void sendBootNotification() {
 
 // Notification functions that return success status for queue management
 
+#if FEATURE_NTFY
 bool sendNtfyNotificationWithStatus(const String& title, const String& message, const String& tags) {
   HTTPClient http;
   String url = String(NTFY_SERVER) + "/" + NTFY_TOPIC;
@@ -3904,7 +7326,13 @@ bool sendNtfyNotificationWithStatus(const String& title, const String& message,
     return false;
   }
 }
+#else
+bool sendNtfyNotificationWithStatus(const String& title, const String& message, const String& tags) {
+  return false;
+}
+#endif  // FEATURE_NTFY
 
+#if FEATURE_DISCORD
 bool sendDiscordNotificationWithStatus(const String& title, const String& message) {
   HTTPClient http;
   String url = String(DISCORD_WEBHOOK_URL);
@@ -3920,7 +7348,7 @@ bool sendDiscordNotificationWithStatus(const String& title, const String& messag
 
   http.addHeader("Content-Type", "application/json");
 
-  JsonDocument doc;
+  JsonDocument doc(&notifyMemory);
   doc["content"] = "**" + title + "**\n" + message;
 
   String payload;
@@ -3937,7 +7365,13 @@ bool sendDiscordNotificationWithStatus(const String& title, const String& messag
     return false;
   }
 }
+#else
+bool sendDiscordNotificationWithStatus(const String& title, const String& message) {
+  return false;
+}
+#endif  // FEATURE_DISCORD
 
+#if FEATURE_SMTP
 bool sendSmtpNotificationWithStatus(const String& title, const String& message) {
   WiFiClient plainClient;
   WiFiClientSecure secureClient;
@@ -3993,6 +7427,11 @@ bool sendSmtpNotificationWithStatus(const String& title, const String& message)
   Serial.println("SMTP notification sent");
   return true;
 }
+#else
+bool sendSmtpNotificationWithStatus(const String& title, const String& message) {
+  return false;
+}
+#endif  // FEATURE_SMTP
 
 bool sendMeshCoreNotificationWithStatus(const String& title, const String& message) {
 #ifdef HAS_LORA_RADIO
@@ -4192,6 +7631,20 @@ void queueNotification(const String& serviceId, const String& title, const Strin
   }
 }
 
+// Called by the queue's owner after each probe pass (see notificationQueueDepth)
+void publishNotificationQueueDepth() {
+  NotificationQueueDepth depth = {0, 0, 0, 0};
+  for (int i = 0; i < queuedNotificationCount; i++) {
+    if (notificationQueue[i].ntfyPending) depth.ntfy++;
+    if (notificationQueue[i].discordPending) depth.discord++;
+    if (notificationQueue[i].smtpPending) depth.smtp++;
+    if (notificationQueue[i].meshPending) depth.mesh++;
+  }
+  portENTER_CRITICAL(&notificationQueueDepthMux);
+  notificationQueueDepth = depth;
+  portEXIT_CRITICAL(&notificationQueueDepthMux);
+}
+
 void processNotificationQueue() {
   if (queuedNotificationCount == 0) return;
   
@@ -4206,6 +7659,11 @@ void processNotificationQueue() {
     if (currentTime - notification.lastRetry < NOTIFICATION_RETRY_INTERVAL) {
       continue;
     }
+
+    // Recoveries are held back while memory pressure defers them
+    if (notification.isUp && currentPressurePolicy().deferRecoveryAlerts) {
+      continue;
+    }
     
     notification.lastRetry = currentTime;
     
@@ -4436,6 +7894,9 @@ void processMeshCoreQueue() {
 }
 
 void saveServices() {
+  // Every add/edit/delete/import ends here, so keep the token index in step
+  rebuildServiceIndexes();
+
   if (!littleFsReady) {
     Serial.println("LittleFS not mounted; skipping saveServices");
     return;
@@ -4447,28 +7908,30 @@ void saveServices() {
     return;
   }
 
-  JsonDocument doc;
+  JsonDocument doc(&configMemory);
   JsonArray array = doc["services"].to<JsonArray>();
 
   for (int i = 0; i < serviceCount; i++) {
     JsonObject obj = array.add<JsonObject>();
     obj["id"] = services[i].id;
     obj["name"] = services[i].name;
+    obj["tags"] = services[i].tags;
+    obj["group"] = services[i].group;
     obj["type"] = (int)services[i].type;
-    obj["host"] = services[i].host;
+    obj["host"] = services[i].config.get(CFG_HOST);
     obj["port"] = services[i].port;
-    obj["path"] = services[i].path;
-    obj["url"] = services[i].url;
-    obj["expectedResponse"] = services[i].expectedResponse;
+    obj["path"] = services[i].config.get(CFG_PATH);
+    obj["url"] = services[i].config.get(CFG_URL);
+    obj["expectedResponse"] = services[i].config.get(CFG_EXPECTED_RESPONSE);
     obj["checkInterval"] = services[i].checkInterval;
     obj["passThreshold"] = services[i].passThreshold;
     obj["failThreshold"] = services[i].failThreshold;
     obj["rearmCount"] = services[i].rearmCount;
     // SNMP-specific fields
-    obj["snmpOid"] = services[i].snmpOid;
-    obj["snmpCommunity"] = services[i].snmpCommunity;
+    obj["snmpOid"] = services[i].config.get(CFG_SNMP_OID);
+    obj["snmpCommunity"] = services[i].config.get(CFG_SNMP_COMMUNITY);
     obj["snmpCompareOp"] = (int)services[i].snmpCompareOp;
-    obj["snmpExpectedValue"] = services[i].snmpExpectedValue;
+    obj["snmpExpectedValue"] = services[i].config.get(CFG_SNMP_EXPECTED_VALUE);
     // Push-specific fields
     obj["pushToken"] = services[i].pushToken;
     // Enable/disable and pause fields
@@ -4493,7 +7956,7 @@ void loadServices() {
     Serial.println("No services.json found, creating empty services list");
     File newFile = LittleFS.open("/services.json", "w");
     if (newFile) {
-      JsonDocument emptyDoc;
+      JsonDocument emptyDoc(&configMemory);
       emptyDoc.createNestedArray("services");
       serializeJson(emptyDoc, newFile);
       newFile.close();
@@ -4508,7 +7971,7 @@ void loadServices() {
     return;
   }
 
-  JsonDocument doc;
+  JsonDocument doc(&configMemory);
   DeserializationError error = deserializeJson(doc, file);
   file.close();
 
@@ -4525,31 +7988,45 @@ void loadServices() {
 
     services[serviceCount].id = obj["id"].as<String>();
     services[serviceCount].name = obj["name"].as<String>();
+    services[serviceCount].tags = obj["tags"] | "";
+    services[serviceCount].group = obj["group"] | "";
     services[serviceCount].type = (ServiceType)obj["type"].as<int>();
-    services[serviceCount].host = obj["host"].as<String>();
+    if (!CheckTypes::contains(services[serviceCount].type)) {
+      Serial.printf("WARN: service '%s' uses check type %d, which this build leaves out\n",
+                    obj["name"] | "", (int)services[serviceCount].type);
+    }
     services[serviceCount].port = obj["port"];
-    services[serviceCount].path = obj["path"].as<String>();
-    services[serviceCount].url = obj["url"] | "";
+    bool configStored =
+        services[serviceCount].config.set(CFG_HOST, obj["host"].as<String>()) &&
+        services[serviceCount].config.set(CFG_PATH, obj["path"].as<String>()) &&
+        services[serviceCount].config.set(CFG_URL, obj["url"] | "") &&
+        services[serviceCount].config.set(CFG_EXPECTED_RESPONSE, obj["expectedResponse"].as<String>()) &&
+        services[serviceCount].config.set(CFG_SNMP_OID, obj["snmpOid"] | "") &&
+        services[serviceCount].config.set(CFG_SNMP_COMMUNITY, obj["snmpCommunity"] | "public") &&
+        services[serviceCount].config.set(CFG_SNMP_EXPECTED_VALUE, obj["snmpExpectedValue"] | "");
     // Backward compatibility: generate URL from host/port/path if URL is empty
-    if (services[serviceCount].url.length() == 0 && 
+    if (configStored &&
+        services[serviceCount].config.length(CFG_URL) == 0 && 
         services[serviceCount].type == TYPE_HTTP_GET &&
-        services[serviceCount].host.length() > 0) {
+        services[serviceCount].config.length(CFG_HOST) > 0) {
       // Use HTTPS if port is 443, otherwise use HTTP
       String protocol = (services[serviceCount].port == 443) ? "https://" : "http://";
-      services[serviceCount].url = protocol + services[serviceCount].host + 
+      configStored = services[serviceCount].config.set(CFG_URL, protocol + services[serviceCount].config.get(CFG_HOST) + 
                                    ":" + String(services[serviceCount].port) + 
-                                   services[serviceCount].path;
+                                   services[serviceCount].config.get(CFG_PATH));
+    }
+    if (!configStored) {
+      // Half-built targets must not be checked or written back as empty strings
+      recordSystemEvent("load", "Skipped service '%s': no heap for its config", obj["name"] | "");
+      services[serviceCount].config = ServiceConfigStrings();
+      continue;
     }
-    services[serviceCount].expectedResponse = obj["expectedResponse"].as<String>();
     services[serviceCount].checkInterval = obj["checkInterval"];
     services[serviceCount].passThreshold = obj["passThreshold"] | 1;
     services[serviceCount].failThreshold = obj["failThreshold"] | 3;
     services[serviceCount].rearmCount = obj["rearmCount"] | 1440;
     // SNMP-specific fields
-    services[serviceCount].snmpOid = obj["snmpOid"] | "";
-    services[serviceCount].snmpCommunity = obj["snmpCommunity"] | "public";
     services[serviceCount].snmpCompareOp = (SnmpCompareOp)(obj["snmpCompareOp"].as<int>());
-    services[serviceCount].snmpExpectedValue = obj["snmpExpectedValue"] | "";
     // Push-specific fields
     services[serviceCount].pushToken = obj["pushToken"] | "";
     services[serviceCount].lastPush = 0;
@@ -4562,13 +8039,17 @@ void loadServices() {
     services[serviceCount].lastUptime = 0;
     services[serviceCount].lastError = "";
     services[serviceCount].secondsSinceLastCheck = -1;
+    resetServiceTelemetry(services[serviceCount]);
     // Enable/disable and pause fields
     services[serviceCount].enabled = obj["enabled"] | true;  // Default to enabled
     services[serviceCount].pauseUntil = obj["pauseUntil"] | 0;
+    markServiceConfigChanged(services[serviceCount]);
 
     serviceCount++;
   }
 
+  rebuildServiceIndexes();
+  publishStatusSnapshot();  // Runs from setup() before the web server and checks start
   Serial.printf("Loaded %d services\n", serviceCount);
 }
 
@@ -4576,12 +8057,9 @@ void loadServices() {
 
 // Get history array index for a given service ID
 int getHistoryIndex(const String& serviceId) {
-  for (int i = 0; i < MAX_SERVICES; i++) {
-    if (serviceHistories[i].serviceId == serviceId) {
-      return i;
-    }
-  }
-  return -1;
+  return historyIdIndex.find(fnv1aHash(serviceId.c_str(), serviceId.length()), [&](int index) {
+    return serviceHistories[index].serviceId == serviceId;
+  });
 }
 
 // Initialize history tracking for a new service
@@ -4601,11 +8079,13 @@ void initServiceHistory(const String& serviceId) {
   }
   
   serviceHistories[index].serviceId = serviceId;
+  historyIdIndex.insert(fnv1aHash(serviceId.c_str(), serviceId.length()), index);
   serviceHistories[index].hourlyUptime.clear();
   serviceHistories[index].firstHourTimestamp = 0;
   serviceHistories[index].checksThisHour = 0;
   serviceHistories[index].passesThisHour = 0;
   serviceHistories[index].currentHourStart = 0;
+  markHistoryChanged(serviceHistories[index]);
   
   Serial.printf("Initialized history for service: %s\n", serviceId.c_str());
 }
@@ -4636,6 +8116,8 @@ void finalizeCurrentHour(int historyIndex) {
   // Reset counters for next hour
   serviceHistories[historyIndex].checksThisHour = 0;
   serviceHistories[historyIndex].passesThisHour = 0;
+  markHistoryChanged(serviceHistories[historyIndex]);
+  publishHistoryChanged(serviceHistories[historyIndex].serviceId);
 }
 
 // Record a check result for historical tracking
@@ -4676,6 +8158,9 @@ void recordCheckResult(const String& serviceId, bool isUp) {
         serviceHistories[historyIndex].firstHourTimestamp += 3600;
       }
     }
+    if (missedHours > 0) {
+      markHistoryChanged(serviceHistories[historyIndex]);
+    }
     
     serviceHistories[historyIndex].currentHourStart = currentHour;
   }
@@ -4687,7 +8172,9 @@ void recordCheckResult(const String& serviceId, bool isUp) {
   }
 }
 
-// Save history to filesystem
+// Save history to filesystem (aggregator task only, without servicesMutex held).
+// Each entry is copied into its document under the lock and written to flash
+// after it is released.
 void saveHistory() {
   if (!littleFsReady) {
     Serial.println("LittleFS not mounted; skipping saveHistory");
@@ -4700,90 +8187,484 @@ void saveHistory() {
     return;
   }
   
-  JsonDocument doc;
-  JsonArray array = doc["histories"].to<JsonArray>();
-  
+  // Written one entry at a time: a single document holding every service's
+  // hourly buckets would not fit in RAM once MAX_SERVICES is in the hundreds
   size_t totalBytes = 0;
+  size_t written = file.print("{\"histories\":[");
+  bool first = true;
+  for (int i = 0; i < MAX_SERVICES; i++) {
+    JsonDocument doc(&historyMemory);
+    if (!xSemaphoreTake(servicesMutex, portMAX_DELAY)) continue;
+    bool used = serviceHistories[i].serviceId.length() > 0;
+    if (used) {
+      JsonObject obj = doc.to<JsonObject>();
+      obj["serviceId"] = serviceHistories[i].serviceId;
+      obj["firstHourTimestamp"] = (unsigned long)serviceHistories[i].firstHourTimestamp;
+      obj["currentHourStart"] = (unsigned long)serviceHistories[i].currentHourStart;
+      obj["checksThisHour"] = serviceHistories[i].checksThisHour;
+      obj["passesThisHour"] = serviceHistories[i].passesThisHour;
+
+      // Store hourly uptime as array
+      JsonArray uptimeArray = obj["hourlyUptime"].to<JsonArray>();
+      for (uint8_t uptime : serviceHistories[i].hourlyUptime) {
+        uptimeArray.add(uptime);
+      }
+      totalBytes += serviceHistories[i].hourlyUptime.size();
+    }
+    xSemaphoreGive(servicesMutex);
+    if (!used) continue;
+
+    if (!first) {
+      written += file.print(",");
+    }
+    first = false;
+    written += serializeJson(doc, file);
+  }
+  written += file.print("]}");
+  
+  if (written == 0) {
+    Serial.println("Failed to serialize history.json");
+  } else {
+    Serial.printf("History saved (%zu bytes tracked)\n", totalBytes);
+  }
+  file.close();
+}
+
+// Load history from filesystem
+void loadHistory() {
+  if (!littleFsReady) {
+    Serial.println("LittleFS not mounted; skipping loadHistory");
+    return;
+  }
+  
+  // Initialize all histories to empty
+  historyIdIndex.clear();
   for (int i = 0; i < MAX_SERVICES; i++) {
-    if (serviceHistories[i].serviceId.length() == 0) continue;
+    serviceHistories[i].serviceId = "";
+    serviceHistories[i].hourlyUptime.clear();
+    serviceHistories[i].firstHourTimestamp = 0;
+    serviceHistories[i].checksThisHour = 0;
+    serviceHistories[i].passesThisHour = 0;
+    serviceHistories[i].currentHourStart = 0;
+  }
+  
+  File file = LittleFS.open("/history.json", "r");
+  if (!file) {
+    Serial.println("No history.json found, starting fresh");
+    return;
+  }
+  
+  // Parsed one entry at a time, matching saveHistory()
+  if (!file.find("\"histories\":[")) {
+    file.close();
+    Serial.println("Failed to parse history.json");
+    return;
+  }
+
+  int historyCount = 0;
+  bool more = file.peek() != ']';
+  while (more && historyCount < MAX_SERVICES) {
+    JsonDocument doc(&historyMemory);
+    DeserializationError error = deserializeJson(doc, file);
+    if (error) {
+      Serial.println("Failed to parse history.json entry");
+      break;
+    }
+    JsonObject obj = doc.as<JsonObject>();
     
-    JsonObject obj = array.add<JsonObject>();
-    obj["serviceId"] = serviceHistories[i].serviceId;
-    obj["firstHourTimestamp"] = (unsigned long)serviceHistories[i].firstHourTimestamp;
-    obj["currentHourStart"] = (unsigned long)serviceHistories[i].currentHourStart;
-    obj["checksThisHour"] = serviceHistories[i].checksThisHour;
-    obj["passesThisHour"] = serviceHistories[i].passesThisHour;
+    serviceHistories[historyCount].serviceId = obj["serviceId"].as<String>();
+    historyIdIndex.insert(fnv1aHash(serviceHistories[historyCount].serviceId.c_str(),
+                                    serviceHistories[historyCount].serviceId.length()), historyCount);
+    serviceHistories[historyCount].firstHourTimestamp = obj["firstHourTimestamp"] | 0;
+    serviceHistories[historyCount].currentHourStart = obj["currentHourStart"] | 0;
+    serviceHistories[historyCount].checksThisHour = obj["checksThisHour"] | 0;
+    serviceHistories[historyCount].passesThisHour = obj["passesThisHour"] | 0;
     
-    // Store hourly uptime as array
-    JsonArray uptimeArray = obj["hourlyUptime"].to<JsonArray>();
-    for (uint8_t uptime : serviceHistories[i].hourlyUptime) {
-      uptimeArray.add(uptime);
+    JsonArray uptimeArray = obj["hourlyUptime"];
+    for (JsonVariant v : uptimeArray) {
+      serviceHistories[historyCount].hourlyUptime.push_back(v.as<uint8_t>());
     }
+    markHistoryChanged(serviceHistories[historyCount]);
     
-    totalBytes += serviceHistories[i].hourlyUptime.size();
+    historyCount++;
+    more = file.findUntil(",", "]");
   }
+  file.close();
   
-  if (serializeJson(doc, file) == 0) {
-    Serial.println("Failed to serialize history.json");
+  Serial.printf("Loaded history for %d services\n", historyCount);
+}
+
+// Seconds since the last completed check, -1 if never checked
+static int getSecondsSinceLastCheck(const ServiceStatus& service, unsigned long currentTime) {
+  return service.lastCheck > 0 ? (int)((currentTime - service.lastCheck) / 1000) : -1;
+}
+
+// Fields that only change when the service is added, edited or loaded
+static void addServiceConfigJson(JsonObject obj, const ServiceInfo& service) {
+  obj["id"] = service.id;
+  obj["name"] = service.name;
+  obj["tags"] = service.tags;
+  obj["group"] = service.group;
+  obj["type"] = getServiceTypeString(service.type);
+  obj["host"] = service.config.get(CFG_HOST);
+  obj["port"] = service.port;
+  obj["path"] = service.config.get(CFG_PATH);
+  obj["url"] = service.config.get(CFG_URL);
+  obj["expectedResponse"] = service.config.get(CFG_EXPECTED_RESPONSE);
+  obj["checkInterval"] = service.checkInterval;
+  obj["passThreshold"] = service.passThreshold;
+  obj["failThreshold"] = service.failThreshold;
+  obj["rearmCount"] = service.rearmCount;
+  // SNMP-specific fields
+  obj["snmpOid"] = service.config.get(CFG_SNMP_OID);
+  obj["snmpCommunity"] = service.config.get(CFG_SNMP_COMMUNITY);
+  obj["snmpCompareOp"] = getSnmpCompareOpString(service.snmpCompareOp);
+  obj["snmpExpectedValue"] = service.config.get(CFG_SNMP_EXPECTED_VALUE);
+  // Uptime-specific fields
+  obj["uptimeThreshold"] = service.uptimeThreshold;
+  obj["uptimeCompareOp"] = getSnmpCompareOpString(service.uptimeCompareOp);
+  // Push-specific fields
+  obj["pushToken"] = service.pushToken;
+}
+
+// Fields that change with check results, pushes, enable/disable and pause
+static void addServiceRuntimeJson(JsonObject obj, const ServiceStatus& service) {
+  obj["consecutivePasses"] = service.consecutivePasses;
+  obj["consecutiveFails"] = service.consecutiveFails;
+  obj["failedChecksSinceAlert"] = service.failedChecksSinceAlert;
+  obj["isUp"] = service.isUp;
+  obj["lastError"] = service.lastError;
+  if (service.lastPushMessage[0] != '\0') {
+    obj["pushMessage"] = service.lastPushMessage;
+  }
+  if (service.hasValue) {
+    obj["lastValue"] = service.lastValue;
+  }
+  // Latency summary (full histogram is exported by the metrics endpoint)
+  if (service.latency.count > 0) {
+    obj["lastLatencyMs"] = service.latency.lastMs;
+    obj["avgLatencyMs"] = (uint32_t)(service.latency.sumMs / service.latency.count);
+  }
+  // Enable/disable and pause fields
+  obj["enabled"] = service.enabled;
+  obj["pauseUntil"] = service.pauseUntil;
+}
+
+// Print a string as a JSON string literal
+static void printJsonString(Print& out, const char* text) {
+  out.print('"');
+  for (const char* p = text; *p != '\0'; p++) {
+    char c = *p;
+    if (c == '"' || c == '\\') {
+      out.print('\\');
+      out.print(c);
+    } else if ((uint8_t)c < 0x20) {
+      out.printf("\\u%04x", (unsigned)(uint8_t)c);
+    } else {
+      out.print(c);
+    }
+  }
+  out.print('"');
+}
+
+static void printJsonBool(Print& out, bool value) {
+  out.print(value ? "true" : "false");
+}
+
+static void printJsonFloat(Print& out, float value) {
+  if (!std::isfinite(value)) {
+    out.print("null");  // As ArduinoJson serializes non-finite numbers
   } else {
-    Serial.printf("History saved (%zu bytes tracked)\n", totalBytes);
+    out.printf("%g", value);
+  }
+}
+
+// One key of the /api/services object, for ?fields= projections. Keys with a
+// present() test are omitted when it fails. Names, values and omissions match
+// addServiceConfigJson(), addServiceRuntimeJson() and the time-derived keys
+// printed by writeServiceJson().
+struct ServiceJsonField {
+  const char* name;
+  bool (*present)(const ServiceStatus& service);  // nullptr = always present
+  void (*write)(Print& out, const ServiceStatus& service, unsigned long now);
+};
+
+static const ServiceJsonField SERVICE_JSON_FIELDS[] = {
+  {"id", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->id.c_str()); }},
+  {"name", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->name.c_str()); }},
+  {"tags", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->tags.c_str()); }},
+  {"group", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->group.c_str()); }},
+  {"type", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, getServiceTypeString(s.info->type).c_str()); }},
+  {"host", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->config.get(CFG_HOST)); }},
+  {"port", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.info->port); }},
+  {"path", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->config.get(CFG_PATH)); }},
+  {"url", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->config.get(CFG_URL)); }},
+  {"expectedResponse", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->config.get(CFG_EXPECTED_RESPONSE)); }},
+  {"checkInterval", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.info->checkInterval); }},
+  {"passThreshold", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.info->passThreshold); }},
+  {"failThreshold", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.info->failThreshold); }},
+  {"rearmCount", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.info->rearmCount); }},
+  {"snmpOid", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->config.get(CFG_SNMP_OID)); }},
+  {"snmpCommunity", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->config.get(CFG_SNMP_COMMUNITY)); }},
+  {"snmpCompareOp", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, getSnmpCompareOpString(s.info->snmpCompareOp).c_str()); }},
+  {"snmpExpectedValue", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->config.get(CFG_SNMP_EXPECTED_VALUE)); }},
+  {"uptimeThreshold", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.info->uptimeThreshold); }},
+  {"uptimeCompareOp", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, getSnmpCompareOpString(s.info->uptimeCompareOp).c_str()); }},
+  {"pushToken", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.info->pushToken.c_str()); }},
+  {"consecutivePasses", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.consecutivePasses); }},
+  {"consecutiveFails", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.consecutiveFails); }},
+  {"failedChecksSinceAlert", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.failedChecksSinceAlert); }},
+  {"isUp", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonBool(out, s.isUp); }},
+  {"lastError", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.lastError); }},
+  {"pushMessage", [](const ServiceStatus& s) { return s.lastPushMessage[0] != '\0'; },
+   [](Print& out, const ServiceStatus& s, unsigned long) { printJsonString(out, s.lastPushMessage); }},
+  {"lastValue", [](const ServiceStatus& s) { return s.hasValue; },
+   [](Print& out, const ServiceStatus& s, unsigned long) { printJsonFloat(out, s.lastValue); }},
+  {"lastLatencyMs", [](const ServiceStatus& s) { return s.latency.count > 0; },
+   [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.latency.lastMs); }},
+  {"avgLatencyMs", [](const ServiceStatus& s) { return s.latency.count > 0; },
+   [](Print& out, const ServiceStatus& s, unsigned long) { out.print((uint32_t)(s.latency.sumMs / s.latency.count)); }},
+  {"enabled", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { printJsonBool(out, s.enabled); }},
+  {"pauseUntil", nullptr, [](Print& out, const ServiceStatus& s, unsigned long) { out.print(s.pauseUntil); }},
+  {"secondsSinceLastCheck", nullptr, [](Print& out, const ServiceStatus& s, unsigned long now) { out.print(getSecondsSinceLastCheck(s, now)); }},
+  {"pauseRemaining", nullptr, [](Print& out, const ServiceStatus& s, unsigned long now) { out.print(getPauseRemainingMs(s.pauseUntil, now) / 1000); }},
+};
+const int SERVICE_JSON_FIELD_COUNT = sizeof(SERVICE_JSON_FIELDS) / sizeof(SERVICE_JSON_FIELDS[0]);
+
+// Displayed state of a service, as used by ?status= and the static status page
+const char* getServiceDisplayState(const ServiceStatus& service, unsigned long now) {
+  if (!service.enabled) return "disabled";
+  if (getPauseRemainingMs(service.pauseUntil, now) > 0) return "paused";
+  if (service.lastCheck == 0) return "pending";
+  return service.isUp ? "up" : "down";
+}
+
+// Split a comma-separated parameter into trimmed, non-empty items
+static void splitQueryList(const String& value, std::vector<String>& items) {
+  int start = 0;
+  while (start <= (int)value.length()) {
+    int comma = value.indexOf(',', start);
+    if (comma < 0) comma = value.length();
+    String item = value.substring(start, comma);
+    item.trim();
+    if (item.length() > 0) {
+      items.push_back(item);
+    }
+    start = comma + 1;
+  }
+}
+
+// Canonical tag list: trimmed, lowercase, no empty entries, e.g. " Prod, web," -> "prod,web"
+String normalizeServiceTags(const String& tags) {
+  std::vector<String> items;
+  splitQueryList(tags, items);
+  String normalized;
+  for (size_t i = 0; i < items.size(); i++) {
+    items[i].toLowerCase();
+    if (normalized.length() > 0) normalized += ",";
+    normalized += items[i];
+  }
+  return normalized;
+}
+
+static bool listContains(const std::vector<String>& items, const String& value) {
+  for (const String& item : items) {
+    if (item.equalsIgnoreCase(value)) return true;
+  }
+  return false;
+}
+
+void parseServiceQuery(AsyncWebServerRequest* request, ServiceQuery& query) {
+  if (request->hasParam("fields")) splitQueryList(request->getParam("fields")->value(), query.fields);
+  if (request->hasParam("status")) splitQueryList(request->getParam("status")->value(), query.statuses);
+  if (request->hasParam("type")) splitQueryList(request->getParam("type")->value(), query.types);
+  if (request->hasParam("tag")) splitQueryList(request->getParam("tag")->value(), query.tags);
+  if (request->hasParam("group")) splitQueryList(request->getParam("group")->value(), query.groups);
+
+  query.sortDescending = false;
+  if (request->hasParam("sort")) {
+    query.sortKey = request->getParam("sort")->value();
+    if (query.sortKey.startsWith("-")) {
+      query.sortDescending = true;
+      query.sortKey = query.sortKey.substring(1);
+    }
+  }
+  query.filtered = !query.statuses.empty() || !query.types.empty() || !query.tags.empty() ||
+                   !query.groups.empty();
+}
+
+bool serviceMatchesQuery(const ServiceStatus& service, const ServiceQuery& query, unsigned long now) {
+  if (!query.statuses.empty() && !listContains(query.statuses, getServiceDisplayState(service, now))) {
+    return false;
+  }
+  if (!query.types.empty() && !listContains(query.types, getServiceTypeString(service.info->type))) {
+    return false;
+  }
+  if (!query.tags.empty()) {
+    std::vector<String> serviceTags;
+    splitQueryList(service.info->tags, serviceTags);
+    bool anyTag = false;
+    for (const String& tag : serviceTags) {
+      if (listContains(query.tags, tag)) {
+        anyTag = true;
+        break;
+      }
+    }
+    if (!anyTag) return false;
+  }
+  if (!query.groups.empty() && !listContains(query.groups, service.info->group)) {
+    return false;
+  }
+  return true;
+}
+
+// Down services first when sorting by status, so the interesting ones lead
+static int getDisplayStateRank(const char* state) {
+  static const char* const order[] = {"down", "pending", "paused", "disabled", "up"};
+  for (int i = 0; i < 5; i++) {
+    if (strcmp(state, order[i]) == 0) return i;
   }
-  file.close();
+  return 5;
 }
 
-// Load history from filesystem
-void loadHistory() {
-  if (!littleFsReady) {
-    Serial.println("LittleFS not mounted; skipping loadHistory");
+// Reorder indexes into snapshot.services per ?sort=; unknown keys keep list order
+void sortServicesForQuery(const StatusSnapshot& snapshot, int* order, int count,
+                          const ServiceQuery& query, unsigned long now) {
+  const String& key = query.sortKey;
+  if (key != "name" && key != "status" && key != "type" && key != "id") {
     return;
   }
-  
-  // Initialize all histories to empty
-  for (int i = 0; i < MAX_SERVICES; i++) {
-    serviceHistories[i].serviceId = "";
-    serviceHistories[i].hourlyUptime.clear();
-    serviceHistories[i].firstHourTimestamp = 0;
-    serviceHistories[i].checksThisHour = 0;
-    serviceHistories[i].passesThisHour = 0;
-    serviceHistories[i].currentHourStart = 0;
-  }
-  
-  File file = LittleFS.open("/history.json", "r");
-  if (!file) {
-    Serial.println("No history.json found, starting fresh");
+
+  bool descending = query.sortDescending;
+  std::stable_sort(order, order + count, [&](int a, int b) {
+    const ServiceStatus& left = snapshot.services[descending ? b : a];
+    const ServiceStatus& right = snapshot.services[descending ? a : b];
+    if (key == "status") {
+      return getDisplayStateRank(getServiceDisplayState(left, now)) <
+             getDisplayStateRank(getServiceDisplayState(right, now));
+    }
+    if (key == "type") {
+      return getServiceTypeString(left.info->type).compareTo(getServiceTypeString(right.info->type)) < 0;
+    }
+    if (key == "id") {
+      return left.info->id.compareTo(right.info->id) < 0;
+    }
+    return strcasecmp(left.info->name.c_str(), right.info->name.c_str()) < 0;
+  });
+}
+
+// Rebuild a cached fragment from one of the add*Json() builders when its version moved
+template <typename Source, typename Builder>
+static const ServiceJsonFragment& refreshJsonFragment(ServiceJsonFragment& fragment, uint32_t version,
+                                                      const Source& service, Builder build) {
+  if (fragment.version == version && fragment.json.size() >= 2) {
+    serviceJsonCacheHits++;
+    return fragment;
+  }
+  serviceJsonCacheMisses++;
+  JsonDocument doc(&apiMemory);
+  build(doc.to<JsonObject>(), service);
+  size_t length = measureJson(doc);
+  fragment.json.resize(length + 1);  // serializeJson() NUL-terminates
+  serializeJson(doc, reinterpret_cast<char*>(fragment.json.data()), fragment.json.size());
+  fragment.json.resize(length);
+  fragment.version = version;
+  return fragment;
+}
+
+// Print a fragment's members without its enclosing braces
+static void writeJsonMembers(Print& out, const ServiceJsonFragment& fragment) {
+  out.write(fragment.json.data() + 1, fragment.json.size() - 2);
+}
+
+// Print one service object, keeping only ?fields= keys when given. The full
+// object is joined from the slot's cached fragments; a projection prints just the
+// requested keys from SERVICE_JSON_FIELDS, in request order.
+void writeServiceJson(Print& out, int slot, const ServiceStatus& service, const ServiceQuery& query, unsigned long now) {
+  if (query.fields.empty()) {
+    ServiceJsonCacheEntry& cached = serviceJsonCache[slot];
+    const ServiceJsonFragment& config =
+      refreshJsonFragment(cached.config, service.configVersion, *service.info, addServiceConfigJson);
+    const ServiceJsonFragment& runtime =
+      refreshJsonFragment(cached.runtime, service.changeVersion, service, addServiceRuntimeJson);
+    out.print("{");
+    writeJsonMembers(out, config);
+    out.print(",");
+    writeJsonMembers(out, runtime);
+    out.printf(",\"secondsSinceLastCheck\":%d,\"pauseRemaining\":%lu}",
+               getSecondsSinceLastCheck(service, now),
+               (unsigned long)(getPauseRemainingMs(service.pauseUntil, now) / 1000));
     return;
   }
-  
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, file);
-  file.close();
-  
-  if (error) {
-    Serial.println("Failed to parse history.json");
-    return;
+
+  // Only names found in the table are printed, so they need no escaping
+  out.print("{");
+  bool first = true;
+  for (size_t i = 0; i < query.fields.size(); i++) {
+    const String& field = query.fields[i];
+    if (std::find(query.fields.begin(), query.fields.begin() + i, field) != query.fields.begin() + i) {
+      continue;
+    }
+    for (int f = 0; f < SERVICE_JSON_FIELD_COUNT; f++) {
+      const ServiceJsonField& entry = SERVICE_JSON_FIELDS[f];
+      if (field != entry.name) continue;
+      if (entry.present == nullptr || entry.present(service)) {
+        if (!first) out.print(",");
+        first = false;
+        out.printf("\"%s\":", entry.name);
+        entry.write(out, service, now);
+      }
+      break;
+    }
   }
-  
-  JsonArray array = doc["histories"];
-  int historyCount = 0;
-  
-  for (JsonObject obj : array) {
-    if (historyCount >= MAX_SERVICES) break;
-    
-    serviceHistories[historyCount].serviceId = obj["serviceId"].as<String>();
-    serviceHistories[historyCount].firstHourTimestamp = obj["firstHourTimestamp"] | 0;
-    serviceHistories[historyCount].currentHourStart = obj["currentHourStart"] | 0;
-    serviceHistories[historyCount].checksThisHour = obj["checksThisHour"] | 0;
-    serviceHistories[historyCount].passesThisHour = obj["passesThisHour"] | 0;
-    
-    JsonArray uptimeArray = obj["hourlyUptime"];
-    for (JsonVariant v : uptimeArray) {
-      serviceHistories[historyCount].hourlyUptime.push_back(v.as<uint8_t>());
+  out.print("}");
+}
+
+// Write one history entry as JSON, limited to the trailing `hours` buckets and
+// averaged every `step` buckets. uptimePercentage still covers the full history
+// so it matches /api/history/<id>. Printed directly to avoid building a JsonDocument.
+void writeHistoryWindowJson(Print& out, int historyIndex, int hours, int step) {
+  const ServiceHistory& history = serviceHistories[historyIndex];
+  int totalHours = history.hourlyUptime.size();
+
+  unsigned long totalUptime = 0;
+  for (uint8_t uptime : history.hourlyUptime) {
+    totalUptime += uptime;
+  }
+  float uptimePercentage = totalHours > 0 ? (float)totalUptime / (float)totalHours : 0.0f;
+
+  // The most recent bucket always closes a full step; the oldest one averages
+  // whatever hours are left over, so a window shorter than a step still reports
+  int windowHours = totalHours < hours ? totalHours : hours;
+  int firstIndex = totalHours - windowHours;
+  int partial = windowHours % step;
+
+  out.printf("{\"serviceId\":\"%s\",\"firstHourTimestamp\":%lu,\"currentHourStart\":%lu,"
+             "\"uptimePercentage\":%.2f,\"hourlyUptime\":[",
+             history.serviceId.c_str(),
+             (unsigned long)(history.firstHourTimestamp + (unsigned long)firstIndex * 3600UL),
+             (unsigned long)history.currentHourStart, uptimePercentage);
+
+  int width = partial > 0 ? partial : step;
+  for (int i = firstIndex; i < totalHours; i += width, width = step) {
+    unsigned int sum = 0;
+    for (int j = 0; j < width; j++) {
+      sum += history.hourlyUptime[i + j];
     }
-    
-    historyCount++;
+    out.printf(i == firstIndex ? "%u" : ",%u", (sum + width / 2) / width);
   }
-  
-  Serial.printf("Loaded history for %d services\n", historyCount);
+  out.print("]}");
+}
+
+// Remember a deleted service for ?since= change-feed clients
+void recordServiceTombstone(const String& serviceId) {
+  ServiceTombstone& slot = serviceTombstones[serviceTombstoneNext];
+  if (slot.version > serviceTombstoneFloor) {
+    serviceTombstoneFloor = slot.version;
+  }
+  slot.id = serviceId;
+  slot.version = ++statusVersion;
+  serviceTombstoneNext = (serviceTombstoneNext + 1) % MAX_SERVICE_TOMBSTONES;
 }
 
 // Remove history for a specific service (when service is deleted)
@@ -4794,29 +8675,30 @@ void removeServiceHistory(const String& serviceId) {
   }
   
   // Clear the history data
+  historyIdIndex.erase(fnv1aHash(serviceId.c_str(), serviceId.length()),
+                       [&](int index) { return index == historyIndex; });
   serviceHistories[historyIndex].serviceId = "";
   serviceHistories[historyIndex].hourlyUptime.clear();
   serviceHistories[historyIndex].firstHourTimestamp = 0;
   serviceHistories[historyIndex].checksThisHour = 0;
   serviceHistories[historyIndex].passesThisHour = 0;
   serviceHistories[historyIndex].currentHourStart = 0;
+  markHistoryChanged(serviceHistories[historyIndex]);
   
   Serial.printf("Removed history for service: %s\n", serviceId.c_str());
   
-  // Save the updated history to disk
-  saveHistory();
+  // Written to disk by the aggregator task
+  historySaveRequested = true;
+  wakeAggregator();
 }
 
 // ---- Event Log Functions ----
 
 // Get event log array index for a given service ID
 int getEventLogIndex(const String& serviceId) {
-  for (int i = 0; i < MAX_SERVICES; i++) {
-    if (serviceEventLogs[i].serviceId == serviceId) {
-      return i;
-    }
-  }
-  return -1;
+  return eventLogIdIndex.find(fnv1aHash(serviceId.c_str(), serviceId.length()), [&](int index) {
+    return serviceEventLogs[index].serviceId == serviceId;
+  });
 }
 
 // Initialize event log for a new service
@@ -4836,6 +8718,7 @@ void initServiceEventLog(const String& serviceId) {
   }
   
   serviceEventLogs[index].serviceId = serviceId;
+  eventLogIdIndex.insert(fnv1aHash(serviceId.c_str(), serviceId.length()), index);
   serviceEventLogs[index].events.clear();
   
   Serial.printf("Initialized event log for service: %s\n", serviceId.c_str());
@@ -4880,10 +8763,9 @@ void recordServiceEvent(const String& serviceId, bool isUp, const String& reason
   Serial.printf("Recorded event for service '%s': %s at %lu\n", 
     serviceId.c_str(), isUp ? "UP" : "DOWN", event.timestamp);
   
-  // Save event logs to disk immediately to prevent data loss
-  // State changes are infrequent enough that flash wear is not a concern
-  // (similar to how saveHistory() is called on every check result)
-  saveEventLogs();
+  // Saved by the aggregator at the end of its pass, so several services going
+  // down together cost one file write
+  eventLogsDirty = true;
 }
 
 // Remove event log for a service
@@ -4894,16 +8776,20 @@ void removeServiceEventLog(const String& serviceId) {
   }
   
   // Clear the event log data
+  eventLogIdIndex.erase(fnv1aHash(serviceId.c_str(), serviceId.length()),
+                        [&](int index) { return index == eventLogIndex; });
   serviceEventLogs[eventLogIndex].serviceId = "";
   serviceEventLogs[eventLogIndex].events.clear();
   
   Serial.printf("Removed event log for service: %s\n", serviceId.c_str());
   
-  // Save the updated event logs to disk
-  saveEventLogs();
+  // Written to disk by the aggregator task
+  eventLogsDirty = true;
+  wakeAggregator();
 }
 
-// Save event logs to LittleFS
+// Save event logs to LittleFS (aggregator task only, without servicesMutex held),
+// copying one service's events under the lock at a time as saveHistory() does
 void saveEventLogs() {
   if (!littleFsReady) {
     Serial.println("WARN: Skipping event log save - LittleFS not ready");
@@ -4916,27 +8802,37 @@ void saveEventLogs() {
     return;
   }
   
-  JsonDocument doc;
-  JsonArray logsArray = doc["eventLogs"].to<JsonArray>();
-  
+  // One service per document, as in saveHistory()
+  file.print("{\"eventLogs\":[");
+  bool first = true;
   for (int i = 0; i < MAX_SERVICES; i++) {
-    if (serviceEventLogs[i].serviceId.length() == 0) continue;
-    
-    JsonObject obj = logsArray.add<JsonObject>();
-    obj["serviceId"] = serviceEventLogs[i].serviceId;
-    
-    JsonArray eventsArray = obj["events"].to<JsonArray>();
-    for (const ServiceEvent& event : serviceEventLogs[i].events) {
-      JsonObject eventObj = eventsArray.add<JsonObject>();
-      eventObj["timestamp"] = event.timestamp;
-      eventObj["isUp"] = event.isUp;
-      if (event.reason.length() > 0) {
-        eventObj["reason"] = event.reason;
+    JsonDocument doc(&eventMemory);
+    if (!xSemaphoreTake(servicesMutex, portMAX_DELAY)) continue;
+    bool used = serviceEventLogs[i].serviceId.length() > 0;
+    if (used) {
+      JsonObject obj = doc.to<JsonObject>();
+      obj["serviceId"] = serviceEventLogs[i].serviceId;
+
+      JsonArray eventsArray = obj["events"].to<JsonArray>();
+      for (const ServiceEvent& event : serviceEventLogs[i].events) {
+        JsonObject eventObj = eventsArray.add<JsonObject>();
+        eventObj["timestamp"] = event.timestamp;
+        eventObj["isUp"] = event.isUp;
+        if (event.reason.length() > 0) {
+          eventObj["reason"] = event.reason;
+        }
       }
     }
+    xSemaphoreGive(servicesMutex);
+    if (!used) continue;
+
+    if (!first) {
+      file.print(",");
+    }
+    first = false;
+    serializeJson(doc, file);
   }
-  
-  serializeJson(doc, file);
+  file.print("]}");
   file.close();
   
   Serial.println("Event logs saved to LittleFS");
@@ -4950,6 +8846,7 @@ void loadEventLogs() {
   }
   
   // Clear existing event logs only if they have data
+  eventLogIdIndex.clear();
   for (int i = 0; i < MAX_SERVICES; i++) {
     if (serviceEventLogs[i].serviceId.length() > 0 || serviceEventLogs[i].events.size() > 0) {
       serviceEventLogs[i].serviceId = "";
@@ -4961,7 +8858,7 @@ void loadEventLogs() {
     Serial.println("No event_logs.json file found - creating empty log");
     File newFile = LittleFS.open("/event_logs.json", "w");
     if (newFile) {
-      JsonDocument emptyDoc;
+      JsonDocument emptyDoc(&eventMemory);
       emptyDoc.createNestedArray("eventLogs");
       serializeJson(emptyDoc, newFile);
       newFile.close();
@@ -4977,22 +8874,27 @@ void loadEventLogs() {
     return;
   }
   
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, file);
-  file.close();
-  
-  if (error) {
-    Serial.printf("ERROR: Failed to parse event_logs.json: %s\n", error.c_str());
+  // Parsed one service at a time, matching saveEventLogs()
+  if (!file.find("\"eventLogs\":[")) {
+    file.close();
+    Serial.println("ERROR: Failed to parse event_logs.json");
     return;
   }
-  
-  JsonArray logsArray = doc["eventLogs"];
+
   int eventLogCount = 0;
-  
-  for (JsonObject obj : logsArray) {
-    if (eventLogCount >= MAX_SERVICES) break;
+  bool more = file.peek() != ']';
+  while (more && eventLogCount < MAX_SERVICES) {
+    JsonDocument doc(&eventMemory);
+    DeserializationError error = deserializeJson(doc, file);
+    if (error) {
+      Serial.printf("ERROR: Failed to parse event_logs.json: %s\n", error.c_str());
+      break;
+    }
+    JsonObject obj = doc.as<JsonObject>();
     
     serviceEventLogs[eventLogCount].serviceId = obj["serviceId"].as<String>();
+    eventLogIdIndex.insert(fnv1aHash(serviceEventLogs[eventLogCount].serviceId.c_str(),
+                                     serviceEventLogs[eventLogCount].serviceId.length()), eventLogCount);
     
     JsonArray eventsArray = obj["events"];
     for (JsonObject eventObj : eventsArray) {
@@ -5004,21 +8906,16 @@ void loadEventLogs() {
     }
     
     eventLogCount++;
+    more = file.findUntil(",", "]");
   }
+  file.close();
   
   Serial.printf("Loaded event logs for %d services\n", eventLogCount);
 }
 
 String getServiceTypeString(ServiceType type) {
-  switch (type) {
-    case TYPE_HTTP_GET: return "http_get";
-    case TYPE_PING: return "ping";
-    case TYPE_SNMP_GET: return "snmp_get";
-    case TYPE_PORT: return "port";
-    case TYPE_PUSH: return "push";
-    case TYPE_UPTIME: return "uptime";
-    default: return "unknown";
-  }
+  const char* name = CheckTypes::name(type);
+  return name != nullptr ? name : "unknown";
 }
 
 // --- LCD and Touch Screen Functions (Conditional) ---
@@ -5221,6 +9118,32 @@ void drawHeader() {
     display.setTextSize(1);
     display.print(WiFi.localIP().toString());
   }
+
+  // Up/down totals, read from the aggregate counts
+  {
+    StatusSnapshotReader snapshot;
+    const GroupStatus& totals = snapshot->groups.totals;
+    char summary[32];
+    snprintf(summary, sizeof(summary), "%d up  %d down", totals.counts[AGG_UP], totals.counts[AGG_DOWN]);
+    display.setTextSize(1);
+    display.setTextColor(totals.counts[AGG_DOWN] > 0 ? TFT_RED : TFT_GREEN, TFT_NAVY);
+    display.setCursor(width - POWER_BUTTON_SIZE - 100, 22);
+    display.print(summary);
+  }
+
+  // Local warning that HTTPS alerts may stop going out (see sampleHeap())
+  if (heapTlsAlert) {
+    display.setTextSize(1);
+    display.setTextColor(TFT_MAGENTA, TFT_NAVY);
+    display.setCursor(width - POWER_BUTTON_SIZE - 100, 34);
+    display.print("LOW MEMORY");
+  } else if (memoryPressure != PRESSURE_NORMAL) {
+    // Shedding load (auto-refresh is paused, so this view may be stale)
+    display.setTextSize(1);
+    display.setTextColor(TFT_YELLOW, TFT_NAVY);
+    display.setCursor(width - POWER_BUTTON_SIZE - 100, 34);
+    display.printf("MEM %s", currentPressurePolicy().name);
+  }
   
   // Power button (top right)
   int powerBtnX = width - POWER_BUTTON_SIZE - 5;
@@ -5236,7 +9159,7 @@ void drawHeader() {
 }
 
 // Get status color for a service
-uint16_t getServiceStatusColor(const Service& svc) {
+uint16_t getServiceStatusColor(const ServiceStatus& svc) {
   if (!svc.enabled) {
     return TFT_DARKGREY;
   }
@@ -5252,6 +9175,7 @@ uint16_t getServiceStatusColor(const Service& svc) {
 // Render main view showing all services as buttons
 void renderMainView() {
   if (!displayReady) return;
+  StatusSnapshotReader snapshot;
 
   display.startWrite();
   display.fillScreen(TFT_BLACK);
@@ -5263,7 +9187,7 @@ void renderMainView() {
   drawHeader();
 
   // Show message if no services configured
-  if (serviceCount == 0) {
+  if (snapshot->count == 0) {
     display.setCursor(10, HEADER_HEIGHT + 20);
     display.setTextColor(TFT_WHITE, TFT_BLACK);
     display.setTextSize(2);
@@ -5282,14 +9206,14 @@ void renderMainView() {
   int maxRows = availableHeight / (SERVICE_BUTTON_HEIGHT + SERVICE_BUTTON_MARGIN);
   
   // Draw service buttons
-  for (int i = 0; i < serviceCount && i < maxRows * cols; i++) {
+  for (int i = 0; i < snapshot->count && i < maxRows * cols; i++) {
     int row = i / cols;
     int col = i % cols;
     
     int btnX = SERVICE_BUTTON_MARGIN + col * (buttonWidth + SERVICE_BUTTON_MARGIN);
     int btnY = startY + row * (SERVICE_BUTTON_HEIGHT + SERVICE_BUTTON_MARGIN);
     
-    Service& svc = services[i];
+    const ServiceStatus& svc = snapshot->services[i];
     uint16_t statusColor = getServiceStatusColor(svc);
     
     // Button background
@@ -5301,7 +9225,7 @@ void renderMainView() {
     // Service name (truncate if too long)
     display.setTextColor(TFT_WHITE, TFT_DARKGREY);
     display.setTextSize(2);
-    String name = svc.name;
+    String name = svc.info->name;
     if (name.length() > 12) {
       name = name.substring(0, 10) + "..";
     }
@@ -5324,11 +9248,11 @@ void renderMainView() {
   }
   
   // Show indicator if there are more services than can fit
-  if (serviceCount > maxRows * cols) {
+  if (snapshot->count > maxRows * cols) {
     display.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
     display.setTextSize(1);
     display.setCursor(width / 2 - 40, height - 15);
-    display.printf("+ %d more", serviceCount - maxRows * cols);
+    display.printf("+ %d more", snapshot->count - maxRows * cols);
   }
   display.endWrite();
 }
@@ -5336,7 +9260,8 @@ void renderMainView() {
 // Render detail view for a single service
 void renderDetailView() {
   if (!displayReady) return;
-  if (currentServiceIndex >= serviceCount) {
+  StatusSnapshotReader snapshot;
+  if (currentServiceIndex >= snapshot->count) {
     currentView = VIEW_MAIN;
     displayNeedsUpdate = true;
     return;
@@ -5348,7 +9273,8 @@ void renderDetailView() {
   int16_t width = display.width();
   int16_t height = display.height();
 
-  Service& svc = services[currentServiceIndex];
+  const ServiceStatus& svc = snapshot->services[currentServiceIndex];
+  const ServiceInfo& info = *svc.info;
   
   // Header with back button
   display.fillRect(0, 0, width, HEADER_HEIGHT, TFT_NAVY);
@@ -5364,7 +9290,7 @@ void renderDetailView() {
   // Service name in header
   display.setTextColor(TFT_CYAN, TFT_NAVY);
   display.setCursor(75, 15);
-  String headerName = svc.name;
+  String headerName = info.name;
   if (headerName.length() > 18) {
     headerName = headerName.substring(0, 16) + "..";
   }
@@ -5398,17 +9324,17 @@ void renderDetailView() {
   display.setTextSize(2);
   display.setTextColor(TFT_YELLOW, TFT_BLACK);
   display.setCursor(10, contentY);
-  display.printf("Type: %s", getServiceTypeString(svc.type).c_str());
+  display.printf("Type: %s", getServiceTypeString(info.type).c_str());
   contentY += 25;
   
   // Host/URL information
   display.setTextColor(TFT_WHITE, TFT_BLACK);
-  if (svc.type == TYPE_HTTP_GET && svc.url.length() > 0) {
+  if (info.type == TYPE_HTTP_GET && info.config.length(CFG_URL) > 0) {
     display.setCursor(10, contentY);
     display.print("URL:");
     contentY += 20;
     display.setTextSize(1);
-    String urlDisplay = svc.url;
+    String urlDisplay = info.config.get(CFG_URL);
     // Wrap long URLs across multiple lines
     int lines = (urlDisplay.length() + URL_CHARS_PER_LINE - 1) / URL_CHARS_PER_LINE;
     for (int i = 0; i < lines && i < URL_MAX_LINES; i++) {
@@ -5417,25 +9343,25 @@ void renderDetailView() {
       contentY += 12;
     }
     display.setTextSize(2);
-  } else if (svc.type == TYPE_PUSH) {
+  } else if (info.type == TYPE_PUSH) {
     display.setCursor(10, contentY);
     display.print("Push-based monitor");
     contentY += 25;
-  } else if (svc.type == TYPE_PING) {
+  } else if (info.type == TYPE_PING) {
     display.setCursor(10, contentY);
-    display.printf("Host: %s", svc.host.c_str());
+    display.printf("Host: %s", info.config.get(CFG_HOST));
     contentY += 25;
   } else {
     display.setCursor(10, contentY);
-    display.printf("Host: %s:%d", svc.host.c_str(), svc.port);
+    display.printf("Host: %s:%d", info.config.get(CFG_HOST), info.port);
     contentY += 25;
   }
   
   // SNMP-specific info
-  if (svc.type == TYPE_SNMP_GET && svc.snmpOid.length() > 0) {
+  if (info.type == TYPE_SNMP_GET && info.config.length(CFG_SNMP_OID) > 0) {
     display.setCursor(10, contentY);
     display.setTextSize(1);
-    display.printf("OID: %s", svc.snmpOid.c_str());
+    display.printf("OID: %s", info.config.get(CFG_SNMP_OID));
     contentY += 15;
     display.setTextSize(2);
   }
@@ -5445,7 +9371,7 @@ void renderDetailView() {
   // Timing information
   display.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
   display.setCursor(10, contentY);
-  display.printf("Interval: %ds", svc.checkInterval);
+  display.printf("Interval: %ds", info.checkInterval);
   contentY += 25;
   
   display.setCursor(10, contentY);
@@ -5459,7 +9385,7 @@ void renderDetailView() {
   
   // Thresholds
   display.setCursor(10, contentY);
-  display.printf("Thresholds: %d fail / %d pass", svc.failThreshold, svc.passThreshold);
+  display.printf("Thresholds: %d fail / %d pass", info.failThreshold, info.passThreshold);
   contentY += 25;
   
   // Consecutive counts
@@ -5479,7 +9405,7 @@ void renderDetailView() {
   }
   
   // Error message if present
-  if (svc.lastError.length() > 0) {
+  if (svc.lastError[0] != '\0') {
     display.setTextColor(TFT_RED, TFT_BLACK);
     display.setCursor(10, contentY);
     display.print("Error:");
@@ -5620,8 +9546,10 @@ void handleDisplayLoop() {
   
   // Periodically refresh display to update status changes
   // Auto-refresh applies to both main view (all services) and detail view (single service)
+  // and is paused under memory pressure; touches and pressure changes still redraw
   static unsigned long lastAutoRefresh = 0;
   if ((currentView == VIEW_MAIN || currentView == VIEW_DETAIL) && 
+      !currentPressurePolicy().pauseDisplayRefresh &&
       now - lastAutoRefresh >= DISPLAY_AUTO_REFRESH_MS) {
     displayNeedsUpdate = true;
     lastAutoRefresh = now;
@@ -5630,6 +9558,110 @@ void handleDisplayLoop() {
 
 #endif // HAS_LCD
 
+#if FEATURE_DASHBOARD_PAGE || FEATURE_KIOSK_PAGE || FEATURE_ADMIN_PAGE
+// SSE client and polling fallback shared by the dashboard, kiosk and admin pages.
+// Each page defines services, loadServices() and renderServices() and starts the
+// timers itself; this block keeps them in sync with /api/stream.
+static const char LIVE_UPDATES_SCRIPT[] = R"rawliteral(
+        // Live updates: the device pushes compact deltas over Server-Sent Events.
+        // Polling remains as a fallback whenever the stream is not connected.
+        const RESYNC_INTERVAL_MS = 60000;
+        let liveStream = null;
+        let lastFullLoad = 0;
+        let servicesVersion = 0;
+        let servicesEpoch = 0;
+        let reloadTimer = null;
+
+        function stampReceived(service) {
+            service._receivedAt = Date.now();
+            service._checkAgeAtReceive = service.secondsSinceLastCheck;
+            service._pauseAtReceive = service.pauseRemaining;
+        }
+
+        // Advance relative timers locally so "Xs ago" keeps ticking between pushes
+        function advanceClocks() {
+            const now = Date.now();
+            services.forEach(service => {
+                if (service._receivedAt === undefined) return;
+                const elapsed = Math.floor((now - service._receivedAt) / 1000);
+                if (service._checkAgeAtReceive >= 0) service.secondsSinceLastCheck = service._checkAgeAtReceive + elapsed;
+                if (service._pauseAtReceive > 0) service.pauseRemaining = Math.max(0, service._pauseAtReceive - elapsed);
+            });
+        }
+
+        // Coalesce bursts (e.g. every service finalizing its hour at once) into one reload
+        function scheduleReload() {
+            if (reloadTimer) return;
+            reloadTimer = setTimeout(() => {
+                reloadTimer = null;
+                loadServices();
+            }, 1000);
+        }
+
+        function applyServiceDelta(delta) {
+            const service = services.find(s => s.id === delta.id);
+            if (!service) {
+                scheduleReload();
+                return;
+            }
+            Object.assign(service, delta);
+            stampReceived(service);
+            renderServices();
+        }
+
+        function connectLiveUpdates() {
+            if (!window.EventSource) return;
+            liveStream = new EventSource('/api/stream');
+            liveStream.addEventListener('hello', scheduleReload);
+            liveStream.addEventListener('check', e => applyServiceDelta(JSON.parse(e.data)));
+            liveStream.addEventListener('service', scheduleReload);
+            liveStream.addEventListener('removed', scheduleReload);
+            liveStream.addEventListener('history', scheduleReload);
+        }
+
+        // Fallback poll: fetch only services changed since the last response
+        async function pollChanges() {
+            try {
+                const response = await fetch(`/api/services?since=${servicesVersion}&epoch=${servicesEpoch}`);
+                const data = await response.json();
+                const changed = data.services || [];
+                if (data.full || changed.some(delta => !services.find(s => s.id === delta.id))) {
+                    await loadServices();
+                    return;
+                }
+                const removed = data.removed || [];
+                services = services.filter(service => !removed.includes(service.id));
+                changed.forEach(delta => {
+                    const service = services.find(s => s.id === delta.id);
+                    Object.assign(service, delta);
+                    stampReceived(service);
+                });
+                servicesVersion = data.version;
+                advanceClocks();
+                renderServices();
+            } catch (error) {
+                console.error('Error polling service changes:', error);
+            }
+        }
+
+        function refreshTick() {
+            const live = liveStream && liveStream.readyState === EventSource.OPEN;
+            if (!servicesVersion || Date.now() - lastFullLoad >= RESYNC_INTERVAL_MS) {
+                loadServices();
+                return;
+            }
+            if (!live) {
+                pollChanges();
+                return;
+            }
+            advanceClocks();
+            renderServices();
+        }
+
+)rawliteral";
+#endif
+
+#if FEATURE_DASHBOARD_PAGE
 String getWebPage() {
   return R"rawliteral(<!DOCTYPE html>
 <html lang="en">
@@ -5819,10 +9851,14 @@ String getWebPage() {
             <p style="font-size: 0.85em; color: #999; margin-top: 5px;">Build: )rawliteral" + String(BUILD_TIMESTAMP) + R"rawliteral(</p>
             <p style="font-size: 0.85em; color: #999; margin-top: 0px;">Boot: )rawliteral" + bootTimestamp + R"rawliteral(</p>
         </div>
-        <div class="admin-link">
+)rawliteral"
+#if FEATURE_ADMIN_PAGE
+  R"rawliteral(        <div class="admin-link">
             <a href="/admin">Administration Panel</a>
         </div>
-        <div class="status-table" id="statusTable">
+)rawliteral"
+#endif
+  R"rawliteral(        <div class="status-table" id="statusTable">
             <table>
                 <thead>
                     <tr>
@@ -5839,8 +9875,12 @@ String getWebPage() {
         </div>
         <div id="emptyState" class="empty-state hidden">
             <h3>No services configured</h3>
-            <p>Visit the <a href="/admin" style="color: white; text-decoration: underline;">administration panel</a> to add services</p>
-        </div>
+)rawliteral"
+#if FEATURE_ADMIN_PAGE
+  R"rawliteral(            <p>Visit the <a href="/admin" style="color: white; text-decoration: underline;">administration panel</a> to add services</p>
+)rawliteral"
+#endif
+  R"rawliteral(        </div>
     </div>
     
     <!-- Event Log Modal -->
@@ -5859,12 +9899,19 @@ String getWebPage() {
     <script>
         let services = [];
         let serviceHistories = {};
+        // Display last 90 hours (about 4 days) for readability
+        // Full 30 days of data is stored but truncated for display
+        const DISPLAY_HOURS = 90;
         
         async function loadServices() {
             try {
                 const response = await fetch('/api/services');
                 const data = await response.json();
                 services = data.services || [];
+                services.forEach(stampReceived);
+                lastFullLoad = Date.now();
+                servicesVersion = data.version || 0;
+                servicesEpoch = data.epoch || 0;
                 // Sort services alphabetically by name
                 services.sort((a, b) => a.name.localeCompare(b.name));
                 
@@ -5878,19 +9925,20 @@ String getWebPage() {
         }
         
         async function loadHistories() {
-            // Load history for each service
-            const historyPromises = services.map(async service => {
-                try {
-                    const response = await fetch(`/api/history/${service.id}`);
-                    if (response.ok) {
-                        const data = await response.json();
-                        serviceHistories[service.id] = data;
-                    }
-                } catch (error) {
-                    console.error(`Error loading history for ${service.name}:`, error);
+            // Load the displayed window for every service in a single request
+            try {
+                const response = await fetch(`/api/histories?hours=${DISPLAY_HOURS}`);
+                if (response.ok) {
+                    const data = await response.json();
+                    const histories = {};
+                    (data.histories || []).forEach(history => {
+                        histories[history.serviceId] = history;
+                    });
+                    serviceHistories = histories;
                 }
-            });
-            await Promise.all(historyPromises);
+            } catch (error) {
+                console.error('Error loading histories:', error);
+            }
         }
         
         function renderHistoryGraph(serviceId) {
@@ -5899,9 +9947,6 @@ String getWebPage() {
                 return '<div class="history-container"><span class="uptime-percentage">N/A</span></div>';
             }
             
-            // Display last 90 hours (about 4 days) for readability
-            // Full 30 days of data is stored but truncated for display
-            const DISPLAY_HOURS = 90;
             const recentHistory = history.hourlyUptime.slice(-DISPLAY_HOURS);
             const uptimePercent = history.uptimePercentage.toFixed(1);
             
@@ -6082,13 +10127,17 @@ String getWebPage() {
             }
         });
         
-        setInterval(loadServices, 5000);
+)rawliteral" + String(LIVE_UPDATES_SCRIPT) + R"rawliteral(
+        setInterval(refreshTick, 5000);
         loadServices();
+        connectLiveUpdates();
     </script>
 </body>
 </html>)rawliteral";
 }
+#endif
 
+#if FEATURE_KIOSK_PAGE
 String getKioskPage() {
   // Table-only view: same styling as main but no header/build text; centered both axes
   return R"rawliteral(<!DOCTYPE html>
@@ -6179,12 +10228,19 @@ String getKioskPage() {
     <script>
         let services = [];
         let serviceHistories = {};
+        // Display last 90 hours (about 4 days) for readability
+        // Full 30 days of data is stored but truncated for display
+        const DISPLAY_HOURS = 90;
 
         async function loadServices() {
             try {
                 const response = await fetch('/api/services');
                 const data = await response.json();
                 services = data.services || [];
+                services.forEach(stampReceived);
+                lastFullLoad = Date.now();
+                servicesVersion = data.version || 0;
+                servicesEpoch = data.epoch || 0;
                 services.sort((a, b) => a.name.localeCompare(b.name));
                 await loadHistories();
                 renderServices();
@@ -6194,17 +10250,18 @@ String getKioskPage() {
         }
 
         async function loadHistories() {
-            serviceHistories = {};
-            for (const service of services) {
-                try {
-                    const response = await fetch(`/api/history/${service.id}`);
-                    if (response.ok) {
-                        const history = await response.json();
-                        serviceHistories[service.id] = history;
-                    }
-                } catch (error) {
-                    console.error('Error loading history for', service.id, error);
+            try {
+                const response = await fetch(`/api/histories?hours=${DISPLAY_HOURS}`);
+                if (response.ok) {
+                    const data = await response.json();
+                    const histories = {};
+                    (data.histories || []).forEach(history => {
+                        histories[history.serviceId] = history;
+                    });
+                    serviceHistories = histories;
                 }
+            } catch (error) {
+                console.error('Error loading histories:', error);
             }
         }
 
@@ -6226,7 +10283,6 @@ String getKioskPage() {
             if (!history || !history.hourlyUptime || history.hourlyUptime.length === 0) {
                 return '<div class="history-container"><span class="uptime-percentage">N/A</span></div>';
             }
-            const DISPLAY_HOURS = 90;
             const recentHistory = history.hourlyUptime.slice(-DISPLAY_HOURS);
             const bars = recentHistory.map(uptime => {
                 let cls = 'up-0';
@@ -6297,12 +10353,16 @@ String getKioskPage() {
             }).join('');
         }
 
-        setInterval(loadServices, 15000);
+)rawliteral" + String(LIVE_UPDATES_SCRIPT) + R"rawliteral(
+        setInterval(refreshTick, 15000);
         loadServices();
+        connectLiveUpdates();
     </script>
 </body>
 </html>)rawliteral";
 }
+#endif
+#if FEATURE_ADMIN_PAGE
 String getAdminPage() {
   return R"rawliteral(<!DOCTYPE html>
 <html lang="en">
@@ -6799,7 +10859,8 @@ String getAdminPage() {
     <div class="container">
         <div class="header">
             <h1>ESP32 Uptime Monitor - Admin</h1>
-            <p><a href="/" style="color: white; text-decoration: underline; opacity: 0.9;">← Back to Status View</a></p>
+            <p><a href="/" style="color: white; text-decoration: underline; opacity: 0.9;">← Back to Status View</a>
+               &middot; <a href="#" onclick="logout(); return false;" style="color: white; text-decoration: underline; opacity: 0.9;">Log out</a></p>
         </div>
 
         <div id="alertContainer"></div>
@@ -6808,8 +10869,12 @@ String getAdminPage() {
             <div class="card-header">
                 <h2 style="margin: 0; color: #1f2937;">Add New Service</h2>
                 <div class="backup-actions">
-                    <a href="/update" class="btn btn-secondary" target="_blank" rel="noopener noreferrer" title="Open firmware update page">OTA Update</a>
-                    <button type="button" class="btn btn-secondary" onclick="testNotifications()">Test Notifications</button>
+)rawliteral"
+#if FEATURE_OTA
+  R"rawliteral(                    <a href="/update" class="btn btn-secondary" target="_blank" rel="noopener noreferrer" title="Open firmware update page">OTA Update</a>
+)rawliteral"
+#endif
+  R"rawliteral(                    <button type="button" class="btn btn-secondary" onclick="testNotifications()">Test Notifications</button>
                     <button type="button" class="btn btn-secondary" onclick="exportServices()">Export Monitors</button>
                     <label class="btn btn-secondary" for="importFile">Import Monitors</label>
                     <input type="file" id="importFile" accept=".json" onchange="importServices(this.files[0])">
@@ -6821,6 +10886,16 @@ String getAdminPage() {
                     <input type="text" id="serviceName" required placeholder="My Service">
                 </div>
 
+                <div class="form-group">
+                    <label for="serviceTags">Tags (comma-separated, optional)</label>
+                    <input type="text" id="serviceTags" placeholder="prod, web" title="Labels for filtering with /api/services?tag=">
+                </div>
+
+                <div class="form-group">
+                    <label for="serviceGroup">Group (optional)</label>
+                    <input type="text" id="serviceGroup" maxlength="31" placeholder="core" title="Status is summarized per group in /api/groups and in notifications">
+                </div>
+
                 <div class="form-row">
                     <div class="form-group">
                         <label for="serviceType">Service Type</label>
@@ -6966,6 +11041,22 @@ String getAdminPage() {
         let editingServiceId = null;  // Preserve service ID when editing
         let editingPushToken = null;  // Preserve pushToken when editing PUSH services
 
+        // Admin calls are authorized by the session cookie; when it expires the
+        // device answers 401 and we go back through the login page
+        const nativeFetch = window.fetch.bind(window);
+        window.fetch = async (...args) => {
+            const response = await nativeFetch(...args);
+            if (response.status === 401) {
+                window.location.href = '/admin';
+            }
+            return response;
+        };
+
+        async function logout() {
+            await fetch('/api/logout', { method: 'POST' });
+            window.location.href = '/admin';
+        }
+
         // Update form fields based on service type
         document.getElementById('serviceType').addEventListener('change', function() {
             const type = this.value;
@@ -7006,7 +11097,8 @@ String getAdminPage() {
                 responseGroup.classList.add('hidden');
                 snmpOidGroup.classList.add('hidden');
                 snmpCommunityGroup.classList.add('hidden');
-                snmpCompareGroup.classList.add('hidden');
+                // Optional threshold for value= sent with each push
+                snmpCompareGroup.classList.remove('hidden');
                 uptimeGroup.classList.add('hidden');
             } else if (type === 'ping') {
                 hostGroup.classList.remove('hidden');
@@ -7068,6 +11160,8 @@ String getAdminPage() {
 
             const data = {
                 name: document.getElementById('serviceName').value,
+                tags: document.getElementById('serviceTags').value,
+                group: document.getElementById('serviceGroup').value,
                 type: document.getElementById('serviceType').value,
                 host: document.getElementById('serviceHost').value,
                 port: parseInt(document.getElementById('servicePort').value) || 80,
@@ -7124,6 +11218,10 @@ String getAdminPage() {
                 const response = await fetch('/api/services');
                 const data = await response.json();
                 services = data.services || [];
+                services.forEach(stampReceived);
+                lastFullLoad = Date.now();
+                servicesVersion = data.version || 0;
+                servicesEpoch = data.epoch || 0;
                 renderServices();
             } catch (error) {
                 console.error('Error loading services:', error);
@@ -7317,6 +11415,8 @@ String getAdminPage() {
 
             // Populate form with existing values
             document.getElementById('serviceName').value = service.name;
+            document.getElementById('serviceTags').value = service.tags || '';
+            document.getElementById('serviceGroup').value = service.group || '';
             document.getElementById('serviceType').value = service.type;
             document.getElementById('serviceHost').value = service.host || '';
             document.getElementById('servicePort').value = service.port || 80;
@@ -7506,13 +11606,157 @@ String getAdminPage() {
             document.getElementById('importFile').value = '';
         }
 
-        // Auto-refresh services every 5 seconds
-        setInterval(loadServices, 5000);
+)rawliteral" + String(LIVE_UPDATES_SCRIPT) + R"rawliteral(
+        // Auto-refresh every 5 seconds (local clocks only while the live stream is up)
+        setInterval(refreshTick, 5000);
 
         // Initial load
         loadServices();
+        connectLiveUpdates();
         document.getElementById('serviceType').dispatchEvent(new Event('change'));
+
+        // Offer only the check types this firmware was built with
+        fetch('/api/check-types').then(r => r.json()).then(data => {
+            const built = new Set(data.types.map(t => t.type));
+            const select = document.getElementById('serviceType');
+            Array.from(select.options).forEach(option => {
+                if (!built.has(option.value)) option.remove();
+            });
+            select.dispatchEvent(new Event('change'));
+        }).catch(() => {});
+    </script>
+</body>
+</html>)rawliteral";
+}
+#endif
+
+#if FEATURE_ADMIN_PAGE
+String getLoginPage() {
+  return R"rawliteral(<!DOCTYPE html>
+<html lang="en">
+<head>
+    <meta charset="UTF-8">
+    <meta name="viewport" content="width=device-width, initial-scale=1.0">
+    <title>ESP32 Uptime Monitor - Sign In</title>
+    <style>
+        * {
+            margin: 0;
+            padding: 0;
+            box-sizing: border-box;
+        }
+
+        body {
+            font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, Oxygen, Ubuntu, Cantarell, sans-serif;
+            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
+            min-height: 100vh;
+            display: flex;
+            align-items: center;
+            justify-content: center;
+            padding: 20px;
+        }
+
+        .card {
+            background: white;
+            border-radius: 12px;
+            padding: 25px;
+            width: 100%;
+            max-width: 360px;
+            box-shadow: 0 4px 6px rgba(0,0,0,0.1);
+        }
+
+        h1 {
+            font-size: 1.4em;
+            color: #1f2937;
+            margin-bottom: 20px;
+        }
+
+        .form-group {
+            display: flex;
+            flex-direction: column;
+            margin-bottom: 15px;
+        }
+
+        label {
+            font-weight: 600;
+            margin-bottom: 5px;
+            color: #333;
+            font-size: 0.9em;
+        }
+
+        input {
+            padding: 10px;
+            border: 2px solid #e0e0e0;
+            border-radius: 6px;
+            font-size: 1em;
+        }
+
+        input:focus {
+            outline: none;
+            border-color: #667eea;
+        }
+
+        .btn {
+            width: 100%;
+            padding: 12px 24px;
+            border: none;
+            border-radius: 6px;
+            font-size: 1em;
+            font-weight: 600;
+            cursor: pointer;
+            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
+            color: white;
+        }
+
+        .error {
+            color: #dc2626;
+            font-size: 0.9em;
+            margin-bottom: 15px;
+            min-height: 1.2em;
+        }
+    </style>
+</head>
+<body>
+    <form class="card" id="loginForm">
+        <h1>ESP32 Uptime Monitor - Admin</h1>
+        <div class="form-group">
+            <label for="username">Username</label>
+            <input type="text" id="username" autocomplete="username" required autofocus>
+        </div>
+        <div class="form-group">
+            <label for="password">Password</label>
+            <input type="password" id="password" autocomplete="current-password" required>
+        </div>
+        <div class="error" id="error"></div>
+        <button type="submit" class="btn">Sign In</button>
+    </form>
+
+    <script>
+        document.getElementById('loginForm').addEventListener('submit', async function(e) {
+            e.preventDefault();
+            const error = document.getElementById('error');
+            error.textContent = '';
+            try {
+                const response = await fetch('/api/login', {
+                    method: 'POST',
+                    headers: {'Content-Type': 'application/json'},
+                    body: JSON.stringify({
+                        username: document.getElementById('username').value,
+                        password: document.getElementById('password').value
+                    })
+                });
+                if (response.ok) {
+                    window.location.href = '/admin';
+                } else if (response.status === 401) {
+                    error.textContent = 'Invalid username or password';
+                } else {
+                    error.textContent = 'Sign in failed, please try again';
+                }
+            } catch (err) {
+                error.textContent = 'Could not reach the device';
+            }
+        });
     </script>
 </body>
 </html>)rawliteral";
 }
+#endif